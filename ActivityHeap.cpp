@@ -0,0 +1,77 @@
+#include "ActivityHeap.h"
+
+ActivityHeap::ActivityHeap(const vector<double> &activity, int numVars)
+        : activity(activity), positions(numVars + 1, -1) {
+    heap.reserve(numVars);
+}
+
+bool ActivityHeap::empty() const {
+    return heap.empty();
+}
+
+bool ActivityHeap::contains(int var) const {
+    return positions[var] >= 0;
+}
+
+void ActivityHeap::insert(int var) {
+    if (contains(var)) {
+        return;
+    }
+    positions[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    siftUp(heap.size() - 1);
+}
+
+int ActivityHeap::removeMax() {
+    int top = heap[0];
+    heap[0] = heap.back();
+    positions[heap[0]] = 0;
+    heap.pop_back();
+    positions[top] = -1;
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return top;
+}
+
+void ActivityHeap::increased(int var) {
+    if (contains(var)) {
+        siftUp(positions[var]);
+    }
+}
+
+void ActivityHeap::siftUp(size_t i) {
+    int var = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) {
+            break;
+        }
+        heap[i] = heap[parent];
+        positions[heap[i]] = static_cast<int>(i);
+        i = parent;
+    }
+    heap[i] = var;
+    positions[var] = static_cast<int>(i);
+}
+
+void ActivityHeap::siftDown(size_t i) {
+    int var = heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= heap.size()) {
+            break;
+        }
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) {
+            child++;
+        }
+        if (activity[heap[child]] <= activity[var]) {
+            break;
+        }
+        heap[i] = heap[child];
+        positions[heap[i]] = static_cast<int>(i);
+        i = child;
+    }
+    heap[i] = var;
+    positions[var] = static_cast<int>(i);
+}
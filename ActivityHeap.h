@@ -0,0 +1,30 @@
+#ifndef AILAB2_ACTIVITYHEAP_H
+#define AILAB2_ACTIVITYHEAP_H
+
+#include <vector>
+
+using namespace std;
+
+// Binary max-heap of variable ids ordered by an external activity array, with a
+// position index so a variable can be re-sifted after its activity is bumped.
+class ActivityHeap {
+private:
+    const vector<double> &activity;
+    vector<int> heap;
+    vector<int> positions;  // -1 when the variable is not in the heap
+
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+public:
+    ActivityHeap(const vector<double> &activity, int numVars);
+
+    bool empty() const;
+    bool contains(int var) const;
+    void insert(int var);
+    int removeMax();
+    void increased(int var);
+};
+
+
+#endif //AILAB2_ACTIVITYHEAP_H
@@ -0,0 +1,195 @@
+#include "BatchSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include "SudokuEncoder.h"
+#include "SudokuEngine.h"
+#include "ThreadPool.h"
+
+// Puzzles per pool task, and tasks per worker in each window read from the file.
+static const size_t CHUNK_PUZZLES = 256;
+static const size_t CHUNKS_PER_WORKER = 16;
+
+namespace {
+    // Writes chunk outputs in chunk order. Whoever submits the next chunk in line
+    // writes it, along with any later chunks that finished earlier.
+    class OrderedWriter {
+    private:
+        ostream &out;
+        mutex lock;
+        vector<string> pending;
+        vector<bool> ready;
+        size_t next;
+
+    public:
+        OrderedWriter(ostream &out, size_t chunks) : out(out), pending(chunks), ready(chunks, false), next(0) {
+        }
+
+        void submit(size_t chunk, string &text) {
+            lock_guard<mutex> guard(lock);
+            pending[chunk].swap(text);
+            ready[chunk] = true;
+            while (next < ready.size() && ready[next]) {
+                out.write(pending[next].data(), pending[next].size());
+                string().swap(pending[next]);
+                next++;
+            }
+        }
+    };
+}
+
+bool parsePuzzleLine(const string &line, SudokuBoard &board) {
+    size_t length = line.size();
+    if (length && line[length - 1] == '\r') {
+        length--;
+    }
+    if (length != 81) {
+        return false;
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+        char c = line[cell];
+        if (c >= '1' && c <= '9') {
+            board.setCell(cell / 9, cell % 9, c - '0');
+        } else if (c == '.' || c == '0') {
+            board.setCell(cell / 9, cell % 9, 0);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void appendPuzzleLine(const SudokuBoard &board, string &out) {
+    for (int row = 0; row < 9; ++row) {
+        for (int col = 0; col < 9; ++col) {
+            int value = board.board[row][col];
+            out += value ? static_cast<char>('0' + value) : '.';
+        }
+    }
+}
+
+bool solveBatch(const string &filename, const BatchOptions &options, ostream &out, BatchSummary &summary) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    WorkStealingPool pool(options.threads);
+    vector<SudokuEngine> engines(pool.size(), SudokuEngine(options.kernel));
+    // One warm SAT solver per worker, created on first use.
+    vector<unique_ptr<IncrementalSudokuSolver<3>>> satSolvers(pool.size());
+    vector<long long> solvedBy(pool.size(), 0);
+    size_t window = CHUNK_PUZZLES * CHUNKS_PER_WORKER * pool.size();
+    vector<SudokuBoard> puzzles;
+    vector<bool> wellFormed;
+    string line;
+    long long lineNumber = 0;
+    bool more = true;
+
+    while (more) {
+        puzzles.clear();
+        wellFormed.clear();
+        while (puzzles.size() < window && (more = static_cast<bool>(getline(file, line)))) {
+            lineNumber++;
+            if (line.empty() || line == "\r") {
+                continue;
+            }
+            SudokuBoard puzzle;
+            bool parsed = parsePuzzleLine(line, puzzle);
+            if (!parsed) {
+                cerr << filename << ":" << lineNumber << ": not an 81-character puzzle" << endl;
+                summary.malformed++;
+            }
+            puzzles.push_back(puzzle);
+            wellFormed.push_back(parsed);
+        }
+        summary.puzzles += puzzles.size();
+
+        size_t chunks = (puzzles.size() + CHUNK_PUZZLES - 1) / CHUNK_PUZZLES;
+        OrderedWriter writer(out, chunks);
+        pool.run(chunks, [&](int worker, size_t chunk) {
+            size_t begin = chunk * CHUNK_PUZZLES, end = min(begin + CHUNK_PUZZLES, puzzles.size());
+            string text;
+            text.reserve((end - begin) * 82);
+            long long solvedHere = 0;
+            for (size_t i = begin; i < end; ++i) {
+                SudokuBoard solution;
+                bool solved = false;
+                if (!wellFormed[i]) {
+                    solved = false;
+                } else if (options.nativeEngine) {
+                    solved = engines[worker].solve(puzzles[i], solution);
+                } else if (options.reducedEncoding) {
+                    solved = solveSudokuSat(puzzles[i], true, options.solver, solution);
+                } else {
+                    if (!satSolvers[worker]) {
+                        satSolvers[worker].reset(new IncrementalSudokuSolver<3>(options.solver));
+                    }
+                    solved = satSolvers[worker]->solve(puzzles[i], solution);
+                }
+                if (solved) {
+                    solvedHere++;
+                    appendPuzzleLine(solution, text);
+                } else {
+                    text.append(81, '.');
+                }
+                text += '\n';
+            }
+            solvedBy[worker] += solvedHere;
+            writer.submit(chunk, text);
+        });
+    }
+    out.flush();
+
+    for (long long solved: solvedBy) {
+        summary.solved += solved;
+    }
+    summary.unsolved = summary.puzzles - summary.solved - summary.malformed;
+    summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void printBatchSummary(const BatchSummary &summary, ostream &out) {
+    out << "puzzles: " << summary.puzzles << endl;
+    out << "solved: " << summary.solved << endl;
+    out << "unsolved: " << summary.unsolved << endl;
+    out << "malformed: " << summary.malformed << endl;
+    out << "seconds: " << summary.seconds << endl;
+    out << "puzzles/s: " << (summary.seconds > 0 ? summary.puzzles / summary.seconds : 0) << endl;
+}
+
+bool benchmarkBatch(const string &filename, const BatchOptions &options, ostream &report) {
+    vector<int> counts;
+    for (int threads = 1; threads < options.threads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(max(options.threads, 1));
+
+    ostream discard(nullptr);
+    double baseRate = 0;
+    report << setw(8) << "threads" << setw(12) << "seconds" << setw(14) << "puzzles/s" << setw(10) << "speedup"
+           << endl;
+    for (int threads: counts) {
+        BatchOptions run = options;
+        run.threads = threads;
+        BatchSummary summary;
+        if (!solveBatch(filename, run, discard, summary)) {
+            return false;
+        }
+        double rate = summary.seconds > 0 ? summary.puzzles / summary.seconds : 0;
+        if (threads == 1) {
+            baseRate = rate;
+        }
+        report << setw(8) << threads << setw(12) << fixed << setprecision(3) << summary.seconds
+               << setw(14) << setprecision(0) << rate << setw(10) << setprecision(2)
+               << (baseRate > 0 ? rate / baseRate : 0) << endl;
+        report.unsetf(ios::floatfield);
+        report << setprecision(6);
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef AILAB2_BATCHSOLVER_H
+#define AILAB2_BATCHSOLVER_H
+
+#include <iostream>
+#include <string>
+#include "DPLL.h"
+#include "SudokuBoard.h"
+#include "SudokuKernel.h"
+
+// Settings shared by every puzzle of a batch run.
+struct BatchOptions {
+    bool nativeEngine = false;
+    bool reducedEncoding = false;
+    KernelKind kernel = KERNEL_AUTO;
+    SolverOptions solver;
+    int threads = 1;
+};
+
+struct BatchSummary {
+    long long puzzles = 0;
+    long long solved = 0;
+    long long unsolved = 0;
+    long long malformed = 0;
+    double seconds = 0;
+};
+
+// Reads one puzzle in the usual 81-character line format: '1'-'9' for givens,
+// '.' or '0' for blanks. A trailing '\r' is ignored.
+bool parsePuzzleLine(const string &line, SudokuBoard &board);
+
+// Appends the 81 digits of board (row by row, '.' for empty cells) to out.
+void appendPuzzleLine(const SudokuBoard &board, string &out);
+
+// Solves every non-empty line of filename and writes one 81-character line per
+// puzzle to out: the solution, or 81 dots when the puzzle is malformed or has no
+// solution. The file is read in windows of chunks that options.threads workers
+// share through a WorkStealingPool, each with its own engine: the native one,
+// or an IncrementalSudokuSolver that keeps its clauses from puzzle to puzzle
+// (the reduced encoding depends on the givens and is still built per puzzle).
+// Chunk outputs are written in input order as soon as all earlier chunks are
+// out. Returns false if the file cannot be opened.
+bool solveBatch(const string &filename, const BatchOptions &options, ostream &out, BatchSummary &summary);
+
+void printBatchSummary(const BatchSummary &summary, ostream &out);
+
+// Scaling benchmark: solves filename with 1, 2, 4, ... threads up to
+// options.threads, discarding the solutions, and reports throughput and speedup
+// over the single-threaded run.
+bool benchmarkBatch(const string &filename, const BatchOptions &options, ostream &report);
+
+#endif //AILAB2_BATCHSOLVER_H
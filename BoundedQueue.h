@@ -0,0 +1,61 @@
+#ifndef AILAB2_BOUNDEDQUEUE_H
+#define AILAB2_BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+
+// Blocking FIFO between one or more producers and consumers. push() waits while
+// the queue holds capacity items, which bounds the memory a fast producer can
+// run ahead by; close() ends the stream once the producers are done.
+template <typename T>
+class BoundedQueue {
+private:
+    mutex lock;
+    condition_variable notFull;
+    condition_variable notEmpty;
+    deque<T> items;
+    size_t capacity;
+    bool closed;
+
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {
+    }
+
+    // Returns false (dropping item) if the queue was closed.
+    bool push(T item) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Waits for the next item; returns false once the queue is closed and empty.
+    bool pop(T &item) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+#endif //AILAB2_BOUNDEDQUEUE_H
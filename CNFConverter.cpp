@@ -3,14 +3,102 @@
 //
 #include "CNFConverter.h"
 #include <iostream>
-#include<stack>
-#include <unordered_set>
-#include <set>
-#include <sstream>
-#include "unordered_map"
+#include <stack>
+#include <algorithm>
+#include <memory>
+#include "ThreadPool.h"
+
+namespace {
+    // Auxiliary variables are "_t1", "_t2", ...; tokenize() never produces a
+    // name starting with '_', so they cannot clash with formula variables.
+    const string AUX_PREFIX = "_t";
+
+    // Expressions converted per parallel round; bounds the clauses held at once.
+    const size_t WINDOW_EXPRESSIONS = 4096;
+
+    inline int32_t negateLiteral(int32_t literal) {
+        return literal ^ 1;
+    }
+
+    inline int32_t literalVariable(int32_t literal) {
+        return literal >> 1;
+    }
+
+    inline bool isNegated(int32_t literal) {
+        return (literal & 1) != 0;
+    }
+
+    // Clauses seen so far, as sorted literal vectors. Open addressing with
+    // linear probing on a 64-bit fingerprint of the clause; literals are
+    // compared only when fingerprints match.
+    class ClauseSet {
+    private:
+        struct Slot {
+            uint64_t fingerprint;
+            uint32_t clause;  // index + 1, 0 while the slot is empty
+        };
+
+        vector<Slot> slots;
+        vector<int32_t> literals;  // all stored clauses back to back
+        vector<size_t> starts;     // clause i is literals[starts[i], starts[i + 1])
+
+        static uint64_t fingerprint(const vector<int32_t> &clause) {
+            uint64_t hash = 0x9e3779b97f4a7c15ULL ^ clause.size();
+            for (int32_t literal: clause) {
+                hash ^= static_cast<uint32_t>(literal);
+                hash *= 0xff51afd7ed558ccdULL;
+                hash ^= hash >> 32;
+            }
+            return hash;
+        }
+
+        bool sameClause(uint32_t index, const vector<int32_t> &clause) const {
+            size_t begin = starts[index], end = starts[index + 1];
+            return end - begin == clause.size() && equal(clause.begin(), clause.end(), literals.begin() + begin);
+        }
+
+        void grow() {
+            vector<Slot> old(slots.empty() ? 1024 : slots.size() * 2, Slot{0, 0});
+            old.swap(slots);
+            for (const Slot &slot: old) {
+                if (slot.clause) {
+                    size_t i = slot.fingerprint & (slots.size() - 1);
+                    while (slots[i].clause) {
+                        i = (i + 1) & (slots.size() - 1);
+                    }
+                    slots[i] = slot;
+                }
+            }
+        }
+
+    public:
+        ClauseSet() : starts(1, 0) {}
+
+        // False if clause is already in the set.
+        bool insert(const vector<int32_t> &clause) {
+            if (2 * starts.size() >= slots.size()) {
+                grow();
+            }
+            uint64_t hash = fingerprint(clause);
+            size_t i = hash & (slots.size() - 1);
+            while (slots[i].clause) {
+                if (slots[i].fingerprint == hash && sameClause(slots[i].clause - 1, clause)) {
+                    return false;
+                }
+                i = (i + 1) & (slots.size() - 1);
+            }
+            slots[i] = Slot{hash, static_cast<uint32_t>(starts.size())};
+            literals.insert(literals.end(), clause.begin(), clause.end());
+            starts.push_back(literals.size());
+            return true;
+        }
+    };
+}
+const CNFConverter::Lit CNFConverter::CLAUSE_END;
+
 // Implement Token constructor
 
-CNFConverter::Token::Token(TokenType t, string v) : type(t), value(v) {}
+CNFConverter::Token::Token(TokenType t, const char *text, size_t length) : type(t), text(text), length(length) {}
 
 string CNFConverter::tokenToString(const Token &token) {
     switch (token.type) {
@@ -35,144 +123,133 @@ string CNFConverter::tokenToString(const Token &token) {
     }
 }
 
-vector<CNFConverter::Token> CNFConverter::tokenize(const string &expr) {
-    vector<Token> tokens;
-    for (size_t i = 0; i < expr.size(); i++) {
+void CNFConverter::tokenize(const char *expr, size_t length, vector<Token> &tokens) {
+    tokens.clear();
+    for (size_t i = 0; i < length; i++) {
         switch (expr[i]) {
             case '!':
-                tokens.push_back(Token(NOT, "!"));
+                tokens.push_back(Token(NOT, expr + i, 1));
                 break;
             case '^':
-                tokens.push_back(Token(AND, "^"));
+                tokens.push_back(Token(AND, expr + i, 1));
                 break;
             case 'v':
-                tokens.push_back(Token(OR, "v"));
+                tokens.push_back(Token(OR, expr + i, 1));
                 break;
             case '(':
-                tokens.push_back(Token(OPEN_PAREN, "("));
+                tokens.push_back(Token(OPEN_PAREN, expr + i, 1));
                 break;
             case ')':
-                tokens.push_back(Token(CLOSE_PAREN, ")"));
+                tokens.push_back(Token(CLOSE_PAREN, expr + i, 1));
                 break;
             case ' ':
                 break; // skip spaces
             default:
-                if (
-                        (expr[i] == 'n' && i + 7 < expr.length())) {
-                    std::string substr = expr.substr(i, 8);
-                    tokens.push_back(Token(VAR, substr));
-                    i += 7; // 跳过当前提取的字符串的其余部分
+                if (expr[i] == 'n' && i + 1 < length && isdigit(expr[i + 1])) {
+                    // Sudoku name nD_rR_cC; D, R and C may have two digits on 16x16 and 25x25 grids.
+                    size_t end = i + 1;
+                    while (end < length &&
+                           (isdigit(expr[end]) || expr[end] == '_' || expr[end] == 'r' || expr[end] == 'c')) {
+                        end++;
+                    }
+                    tokens.push_back(Token(VAR, expr + i, end - i));
+                    i = end - 1; // 跳过当前提取的字符串的其余部分
                 }
                 if (isupper(expr[i])) {
-                    tokens.push_back(Token(VAR, string(1, expr[i])));
-                } else if (i < expr.size() - 1 && expr[i] == '=' && expr[i + 1] == '>') {
-                    tokens.push_back(Token(IMPLIES, "=>"));
+                    tokens.push_back(Token(VAR, expr + i, 1));
+                } else if (i < length - 1 && expr[i] == '=' && expr[i + 1] == '>') {
+                    tokens.push_back(Token(IMPLIES, expr + i, 2));
                     i++;  // Skip the next character
-                } else if (i < expr.size() - 2 && expr[i] == '<' && expr[i + 1] == '=' && expr[i + 2] == '>') {
-                    tokens.push_back(Token(BICONDITIONAL, "<=>"));
+                } else if (i < length - 2 && expr[i] == '<' && expr[i + 1] == '=' && expr[i + 2] == '>') {
+                    tokens.push_back(Token(BICONDITIONAL, expr + i, 3));
                     i += 2;  // Skip the next two characters
                 }
                 break;
         }
     }
-
-    return tokens;
 }
 
-CNFConverter::Node CNFConverter::expression(const std::vector<Token> &tokens, int &pos) {
-    Node left = and_expression(tokens, pos);
-
-    if (pos < tokens.size()) {
-        if (tokens[pos].type == OR) {
-            pos++;
-            Node right = expression(tokens, pos);
-            return Node("OR", {left, right});
-        } else if (tokens[pos].type == BICONDITIONAL) {
-            pos++;
-            Node right = and_expression(tokens, pos);
-            return Node("BICONDITIONAL", {left, right});
-        }
-    }
-
-    return left;
+CNFConverter::NodeRef CNFConverter::makeNode(NodeOp op, NodeRef left, NodeRef right) {
+    arena.push_back(Node{op, left, right});
+    return static_cast<NodeRef>(arena.size() - 1);
 }
 
-CNFConverter::Node CNFConverter::and_expression(const std::vector<Token> &tokens, int &pos) {
-    Node left = implies_expression(tokens, pos);
-
-    if (pos < tokens.size() && tokens[pos].type == AND) {
-        pos++;
-        Node right = and_expression(tokens, pos);
-        return Node("AND", {left, right});
-    }
-
-    return left;
+int32_t CNFConverter::internVariable(const string &name) {
+    return internVariable(name.data(), name.size());
 }
 
-CNFConverter::Node CNFConverter::implies_expression(const std::vector<Token> &tokens, int &pos) {
-    Node left = factor(tokens, pos);
+int32_t CNFConverter::internVariable(const char *name, size_t length) {
+    // Names already seen (nearly all of them) cost no allocation.
+    nameBuffer.assign(name, length);
+    auto found = variableIds.find(nameBuffer);
+    if (found != variableIds.end()) {
+        return found->second;
+    }
+    int32_t id = static_cast<int32_t>(variableNames.size());
+    variableIds.emplace(nameBuffer, id);
+    variableNames.push_back(nameBuffer);
+    auxNumbers.push_back(0);
+    return id;
+}
 
-    if (pos < tokens.size() && tokens[pos].type == IMPLIES) {
-        pos++;
-        Node right = implies_expression(tokens, pos);
-        return Node("IMPLIES", {left, right});
+int32_t CNFConverter::auxVariable(int32_t number) {
+    if (number >= static_cast<int32_t>(auxIds.size())) {
+        auxIds.resize(number + 1, -1);
     }
-
-    return left;
+    if (auxIds[number] < 0) {
+        auxIds[number] = internVariable(AUX_PREFIX + to_string(number));
+        auxNumbers[auxIds[number]] = number;
+    }
+    return auxIds[number];
 }
 
-CNFConverter::Node CNFConverter::factor(const std::vector<Token> &tokens, int &pos) {
-    if (tokens[pos].type == NOT) {
-        pos++;
-        return Node("NOT", {expression(tokens, pos)});
-    } else if (tokens[pos].type == OPEN_PAREN) {
-        pos++;
-        Node child = expression(tokens, pos);
-        if (tokens[pos].type != CLOSE_PAREN) {
-            std::cerr << "Expected closing parenthesis." << std::endl;
-            return Node{}; // Or throw an exception.
-        }
-        pos++;
-        return child;
-    } else if (tokens[pos].type == VAR) {
-        return Node(tokens[pos++].value, {});
-    } else {
-        std::cerr << "Unexpected token." << std::endl;
-        return Node{}; // Or throw an exception.
-    }
+CNFConverter::NodeRef CNFConverter::makeVariable(const char *name, size_t length) {
+    return makeNode(OP_VAR, internVariable(name, length));
 }
 
+bool CNFConverter::isLeaf(NodeRef node) const {
+    return arena[node].op == OP_VAR;
+}
 
-CNFConverter::Node CNFConverter::parse(const vector<Token> &tokens, int &pos) {
+CNFConverter::NodeRef CNFConverter::parse(const vector<Token> &tokens, int &pos) {
     if (pos >= tokens.size()) {
         cerr << "Unexpected end of tokens." << endl;
-        return Node{};
+        return makeVariable("");
     }
 
-    stack<Node> operands;
+    stack<NodeRef> operands;
     stack<TokenType> operators;
 
     auto applyOperator = [&]() {
         TokenType op = operators.top();
         operators.pop();
 
-        Node right = operands.top();
+        size_t needed = op == NOT ? 1 : 2;
+        if (operands.size() < needed) {
+            return false;
+        }
+        NodeRef right = operands.top();
         operands.pop();
-        Node left = (op == NOT) ? Node{} : operands.top();
-        if (op != NOT) operands.pop();
-        operands.push(Node{tokenTypeToString(op), (op == NOT) ? vector<Node>{right} : vector<Node>{left, right}});
+        if (op == NOT) {
+            operands.push(makeNode(OP_NOT, right));
+        } else {
+            NodeRef left = operands.top();
+            operands.pop();
+            operands.push(makeNode(tokenOperator(op), left, right));
+        }
+        return true;
     };
 
     while (pos < tokens.size() && tokens[pos].type != CLOSE_PAREN) {
         if (tokens[pos].type == VAR) {
-            operands.push(Node{tokens[pos].value, {}});
+            operands.push(makeVariable(tokens[pos].text, tokens[pos].length));
             pos++;
         } else if (tokens[pos].type == OPEN_PAREN) {
             pos++;
             operands.push(parse(tokens, pos));
             if (pos >= tokens.size() || tokens[pos].type != CLOSE_PAREN) {
                 cerr << "Expected closing parenthesis." << endl;
-                return Node{};
+                return makeVariable("");
             }
             pos++;
         } else if (tokens[pos].type == NOT || tokens[pos].type == AND ||
@@ -180,24 +257,32 @@ CNFConverter::Node CNFConverter::parse(const vector<Token> &tokens, int &pos) {
                    tokens[pos].type == IMPLIES ||
                    tokens[pos].type == BICONDITIONAL) {
 
-            while (!operators.empty() && precedence(operators.top()) >= precedence(tokens[pos].type)) {
-                applyOperator();
+            // A prefix NOT has no operand yet, so it cannot complete a pending operator.
+            while (tokens[pos].type != NOT && !operators.empty() &&
+                   precedence(operators.top()) >= precedence(tokens[pos].type)) {
+                if (!applyOperator()) {
+                    cerr << "Invalid expression." << endl;
+                    return makeVariable("");
+                }
             }
             operators.push(tokens[pos].type);
             pos++;
         } else {
             cerr << "Unexpected token type." << endl;
-            return Node{};
+            return makeVariable("");
         }
     }
 
     while (!operators.empty()) {
-        applyOperator();
+        if (!applyOperator()) {
+            cerr << "Invalid expression." << endl;
+            return makeVariable("");
+        }
     }
 
     if (operands.size() != 1) {
         cerr << "Invalid expression." << endl;
-        return Node{};
+        return makeVariable("");
     }
     return operands.top();
 }
@@ -220,393 +305,375 @@ int CNFConverter::precedence(TokenType type) {
 }
 
 
-string CNFConverter::tokenTypeToString(TokenType type) {
+CNFConverter::NodeOp CNFConverter::tokenOperator(TokenType type) {
     switch (type) {
         case AND:
-            return "AND";
+            return OP_AND;
         case OR:
-            return "OR";
+            return OP_OR;
         case IMPLIES:
-            return "IMPLIES";
-        case NOT:
-            return "NOT";
+            return OP_IMPLIES;
         case BICONDITIONAL:
-            return "BICONDITIONAL";
+            return OP_BICONDITIONAL;
         default:
-            return "";
+            return OP_NOT;
     }
 }
 
 
-string CNFConverter::nodeToString(const Node &root) {
-
-    if (root.children.empty()) {
-        return root.type;  // It's a VAR or NOT
+// The literals of an OR tree. AND operations are handled separately by
+// convertToCNF() and add nothing here.
+void CNFConverter::collectDisjuncts(NodeRef root, vector<Lit> &literals) {
+    Node node = arena[root];
+    if (node.op == OP_VAR) {
+        literals.push_back(2 * node.left);
+    } else if (node.op == OP_NOT) {
+        // toCNF() only leaves negations over variables.
+        literals.push_back(2 * arena[node.left].left + 1);
+    } else if (node.op == OP_OR) {
+        collectDisjuncts(node.left, literals);
+        collectDisjuncts(node.right, literals);
     }
-    if (root.type == "NOT") {
-        return "!" + nodeToString(root.children[0]);
-    }
-    // Change this representation to use spaces for ORs
-    if (root.type == "OR") {
-        // Split the elements into a set to remove duplicates
-        std::set<string> uniqueElements;
-
-        std::istringstream leftStream(nodeToString(root.children[0]));
-        std::string item;
-        while (getline(leftStream, item, ' ')) {
-            uniqueElements.insert(item);
-        }
-
-        std::istringstream rightStream(nodeToString(root.children[1]));
-        while (getline(rightStream, item, ' ')) {
-            uniqueElements.insert(item);
-        }
-
-        // Convert the set back to a string
-        std::ostringstream os;
-        for (const auto &elem: uniqueElements) {
-            os << elem << " ";
-        }
-        return os.str().substr(0, os.str().size() - 1);  // Remove the trailing space
-    }
-
-    // No need for this line since AND operations are handled separately.
-    // return "(" + nodeToString(node.children[0]) + " " + node.value + " " + nodeToString(node.children[1]) + ")";
-    return "";
 }
 
 
-vector<string> CNFConverter::convertToCNF(Node &root) {
-    unordered_map<string, bool> clauseMap; // 使用这个map去重
-
-    vector<string> clauses;
-    simplifyDoubleNegation(root);
-    // Base cases: If the root is a variable or negation of a variable
-
-    if (root.type == "VAR" || root.type == "NOT" || root.children.empty()) {
-        return {nodeToString(root)};
-    }
-    if (root.type == "AND") {
-        auto leftClauses = convertToCNF(root.children[0]);
-        auto rightClauses = convertToCNF(root.children[1]);
-        leftClauses.insert(leftClauses.end(), rightClauses.begin(), rightClauses.end());
-        return leftClauses;
-    }
-    // Step 3: Push Negations Inward
-    if (root.type == "NOT") {
-        Node child = root.children[0];
-        if (child.type == "AND" || child.type == "OR") {
-            // De Morgan's Laws
-            string newOp = child.type == "AND" ? "OR" : "AND";
-            Node notLeft = {"NOT", {child.children[0]}};
-            Node notRight = {"NOT", {child.children[1]}};
-            Node deMorgansNode = {newOp, {notLeft, notRight}};
-            return convertToCNF(deMorgansNode);
-        }
-    }
-
-    // Step 4: Distribute OR Over AND
-    if (root.type == "OR") {
-        if (root.children[0].type == "AND") {
-            // (A ^ B) v C becomes (A v C) ^ (B v C)
-            Node leftOr = {"OR", {root.children[0].children[0], root.children[1]}};
-            Node rightOr = {"OR", {root.children[0].children[1], root.children[1]}};
-            Node andNode = {"AND", {leftOr, rightOr}};
-            auto clausesFromAnd = convertToCNF(andNode);
-            clauses.insert(clauses.end(), clausesFromAnd.begin(), clausesFromAnd.end());
-            return clauses;
-        } else if (root.children[1].type == "AND") {
-            // A v (B ^ C) becomes (A v B) ^ (A v C)
-            Node leftOr = {"OR", {root.children[0], root.children[1].children[0]}};
-            Node rightOr = {"OR", {root.children[0], root.children[1].children[1]}};
-            Node andNode = {"AND", {leftOr, rightOr}};
-            auto clausesFromAnd = convertToCNF(andNode);
-            clauses.insert(clauses.end(), clausesFromAnd.begin(), clausesFromAnd.end());
-            return clauses;
-        } else {
-            // if neither child is an AND, just return the OR as it is
-            clauses.push_back(nodeToString(root));
-            return clauses;
-        }
+void CNFConverter::convertToCNF(NodeRef root, vector<Lit> &clauses) {
+    Node node = arena[root];
+    if (node.op == OP_AND) {
+        convertToCNF(node.left, clauses);
+        convertToCNF(node.right, clauses);
+        return;
     }
+    // toCNF() leaves no => or <=>, and no AND below an OR
+    collectDisjuncts(root, clauses);
+    clauses.push_back(CLAUSE_END);
 }
 
-void CNFConverter::simplifyDoubleNegation(Node &root) {
-    if (root.type == "NOT" && root.children[0].type == "NOT") {
-        root = root.children[0].children[0];  // Eliminate the double negation
+// (A ∧ B) ∨ C becomes (A ∨ C) ∧ (B ∨ C), until no AND is left below an OR.
+// Both operands must already be in CNF.
+CNFConverter::NodeRef CNFConverter::distributeOr(NodeRef left, NodeRef right) {
+    Node leftNode = arena[left];
+    Node rightNode = arena[right];
+    if (leftNode.op == OP_AND) {
+        return makeNode(OP_AND, distributeOr(leftNode.left, right), distributeOr(leftNode.right, right));
     }
-
-    for (Node &child: root.children) {
-        simplifyDoubleNegation(child);
+    if (rightNode.op == OP_AND) {
+        return makeNode(OP_AND, distributeOr(left, rightNode.left), distributeOr(left, rightNode.right));
     }
+    return makeNode(OP_OR, left, right);
 }
 
-CNFConverter::Node CNFConverter::toCNF(const Node &node) {
-    if (node.children.empty()) {  // Leaf node (variable or constant)
-        return node;
-    }
-
-    if (node.type == "NOT") {
-        Node child = toCNF(node.children[0]);
-
-        // Handling double negation: ¬¬A => A
-        if (child.type == "NOT") {
-            return child.children[0];
-        } else if (child.type == "AND") {
-            // ¬(A ∧ B) => (¬A ∨ ¬B)
-            return Node{"OR", {Node{"NOT", {child.children[0]}}, Node{"NOT", {child.children[1]}}}};
-        } else if (child.type == "OR") {
-            // ¬(A ∨ B) => (¬A ∧ ¬B)1
-            return toCNF(Node{"AND", {Node{"NOT", {child.children[0]}}, Node{"NOT", {child.children[1]}}}});
-        } else {
-            return Node{"NOT", {child}};
-        }
-    }
-
-    if (node.type == "IMPLIES") {
-        // A → B => ¬A ∨ B
-        Node left = Node{"NOT", {toCNF(node.children[0])}};
-        Node right = toCNF(node.children[1]);
-        return toCNF(Node{"OR", {left, right}});
-    }
-
-    if (node.type == "BICONDITIONAL") {
-        // A ↔ B => (A → B) ∧ (B → A)
-        Node left = toCNF(Node{"IMPLIES", {node.children[0], node.children[1]}});
-        Node right = toCNF(Node{"IMPLIES", {node.children[1], node.children[0]}});
-        return Node{"AND", {left, right}};
-    }
-
-    if (node.type == "AND" || node.type == "OR") {
-        Node left = toCNF(node.children[0]);
-        Node right = toCNF(node.children[1]);
-
-        if (node.type == "OR") {
-            std::vector<Node> terms;
-            if (left.type == "AND") {
-                terms.push_back(Node{"OR", {left.children[0], right}});
-                terms.push_back(Node{"OR", {left.children[1], right}});
-            } else if (right.type == "AND") {
-                terms.push_back(Node{"OR", {left, right.children[0]}});
-                terms.push_back(Node{"OR", {left, right.children[1]}});
-            } else {
-                return Node{"OR", {left, right}};
-            }
-
-            Node combined = terms[0];
-            for (size_t i = 1; i < terms.size(); ++i) {
-                combined = Node{"AND", {combined, terms[i]}};
+// CNF of the subtree at root, or of its negation. Negations are pushed down to
+// the variables on the way, so a negated operand is converted from the
+// original subtree rather than from its CNF.
+CNFConverter::NodeRef CNFConverter::toCNF(NodeRef root, bool negated) {
+    Node node = arena[root];
+    switch (node.op) {
+        case OP_VAR:
+            return negated ? makeNode(OP_NOT, root) : root;
+        case OP_NOT:
+            return toCNF(node.left, !negated);
+        case OP_AND:
+        case OP_OR: {
+            // ¬(A ∧ B) => ¬A ∨ ¬B and ¬(A ∨ B) => ¬A ∧ ¬B
+            NodeRef left = toCNF(node.left, negated);
+            NodeRef right = toCNF(node.right, negated);
+            if ((node.op == OP_AND) != negated) {
+                return makeNode(OP_AND, left, right);
             }
-            return combined;
-        } else { // node.type == "AND"
-            return Node{"AND", {left, right}};
+            return distributeOr(left, right);
+        }
+        case OP_IMPLIES: {
+            // A → B => ¬A ∨ B and ¬(A → B) => A ∧ ¬B
+            NodeRef left = toCNF(node.left, !negated);
+            NodeRef right = toCNF(node.right, negated);
+            return negated ? makeNode(OP_AND, left, right) : distributeOr(left, right);
+        }
+        default: {
+            // A ↔ B => (¬A ∨ B) ∧ (A ∨ ¬B) and ¬(A ↔ B) => (A ∨ B) ∧ (¬A ∨ ¬B)
+            NodeRef left = toCNF(node.left);
+            NodeRef notLeft = toCNF(node.left, true);
+            NodeRef right = toCNF(node.right, negated);
+            NodeRef notRight = toCNF(node.right, !negated);
+            return makeNode(OP_AND, distributeOr(notLeft, right), distributeOr(left, notRight));
         }
     }
-
-    return node;  // Fallback if none of the above conditions are met
 }
 
-void CNFConverter::printTree(const Node &node, string prefix = "") {
+void CNFConverter::printTree(NodeRef root, const string &prefix) {
+    static const char *const names[] = {"VAR", "NOT", "AND", "OR", "IMPLIES", "BICONDITIONAL"};
+    Node node = arena[root];
     cout << prefix;
     if (!prefix.empty()) {
         cout << "-- ";
     }
-    cout << node.type << endl;
+    if (node.op == OP_VAR) {
+        cout << variableNames[node.left] << endl;
+        return;
+    }
+    cout << names[node.op] << endl;
 
-    const auto childCount = node.children.size();
-    for (size_t i = 0; i < childCount; ++i) {
-        // 如果不是最后一个子节点，我们需要在接下来的行中继续绘制竖线
-        const auto childPrefix = prefix + (i < childCount - 1 ? "|  " : "   ");
-        printTree(node.children[i], childPrefix);
+    // 如果不是最后一个子节点，我们需要在接下来的行中继续绘制竖线
+    if (node.op == OP_NOT) {
+        printTree(node.left, prefix + "   ");
+    } else {
+        printTree(node.left, prefix + "|  ");
+        printTree(node.right, prefix + "   ");
     }
 }
 
-void CNFConverter::printAST(const CNFConverter::Node &node, int indent = 0) {
-    if (node.type.empty()) return;
+// Appends the clauses of one expression, before deduplication.
+void CNFConverter::expressionClauses(const char *expr, size_t length, vector<Lit> &clauses) {
+    arena.clear();
+    tokenize(expr, length, tokens);
+    int pos = 0;
+    NodeRef astRoot = parse(tokens, pos); // 解析得到AST
 
-    for (int i = 0; i < indent; ++i) {
-        cout << "  ";  // 两个空格缩进
-    }
+    if (mode == CNF_TSEITIN) {
+        tseitinAssert(astRoot, clauses);
+    } else {
+        NodeRef cnfRoot = toCNF(astRoot);
 
-    cout << node.type;
-    if (!node.children.empty()) {
-        cout << " -> (";
-        for (size_t i = 0; i < node.children.size(); ++i) {
-            if (i != 0) cout << ", ";
-            cout << node.children[i].type;
-        }
-        cout << ")";
+        //transform
+        convertToCNF(cnfRoot, clauses);
     }
-    cout << endl;
+}
 
-    for (const auto &child: node.children) {
-        printAST(child, indent + 1);
+// The order the clause strings have always used: negated literals first, each
+// group sorted by name.
+bool CNFConverter::literalBefore(Lit a, Lit b) const {
+    if (isNegated(a) != isNegated(b)) {
+        return isNegated(a);
     }
+    return variableNames[literalVariable(a)] < variableNames[literalVariable(b)];
 }
 
-
-CNFConverter::Node CNFConverter::simplifyCNF(const Node &node) {
-    if (node.type == "AND") {
-        Node left = simplifyCNF(node.children[0]);
-        Node right = simplifyCNF(node.children[1]);
-        return Node{"AND", {left, right}};
-    } else if (node.type == "OR") {
-        unordered_set<string> literals;
-        for (const auto &child: node.children) {
-            // Remove double negations
-            if (child.type == "NOT" && child.children[0].type == "NOT") {
-                literals.insert(child.children[0].children[0].type);
-            } else if (child.type == "NOT") {
-                literals.insert("!" + child.children[0].type);
-            } else {
-                literals.insert(child.type);
-            }
+string CNFConverter::clauseToString(vector<Lit> &clause) {
+    sort(clause.begin(), clause.end(), [this](Lit a, Lit b) { return literalBefore(a, b); });
+    string result;
+    for (Lit literal: clause) {
+        if (!result.empty()) {
+            result += " ";
         }
-        // If a clause contains both a variable and its negation, it's always true
-        for (const auto &lit: literals) {
-            if (lit[0] == '!' && literals.count(lit.substr(1))) {
-                return Node{"TRUE"};
-            }
-        }
-        vector<Node> newChildren;
-        for (const auto &lit: literals) {
-            if (lit[0] == '!') {
-                newChildren.push_back(Node{"NOT", {Node{lit.substr(1)}}});
-            } else {
-                newChildren.push_back(Node{lit});
-            }
+        if (isNegated(literal)) {
+            result += "!";
         }
-        return Node{"OR", newChildren};
+        result += variableNames[literalVariable(literal)];
     }
-    return node;  // for NOT and literals
+    return result;
 }
 
-CNFConverter::Node CNFConverter::toCNFTree(Node root) {
-    simplifyDoubleNegation(root);
-
-    if (root.type == "VAR" || (root.type == "NOT" && root.children[0].type == "VAR")) {
-        return root;
-    }
-
-    if (root.type == "BICONDITIONAL") {
-        Node implies1 = {"IMPLIES", {root.children[0], root.children[1]}};
-        Node implies2 = {"IMPLIES", {root.children[1], root.children[0]}};
-        return {"AND", {toCNFTree(implies1), toCNFTree(implies2)}};
-    }
-
-    if (root.type == "IMPLIES") {
-        Node notNode = {"NOT", {root.children[0]}};
-        Node orNode = {"OR", {notNode, root.children[1]}};
-        return toCNFTree(orNode);
-    }
-
-    if (root.type == "NOT") {
-        Node child = root.children[0];
-        if (child.type == "OR") {
-            return {"AND", {toCNFTree(Node{"NOT", {child.children[0]}}),
-                            toCNFTree(Node{"NOT", {child.children[1]}})}};
-        }
-        if (child.type == "AND") {
-            return {"OR", {toCNFTree(Node{"NOT", {child.children[0]}}),
-                           toCNFTree(Node{"NOT", {child.children[1]}})}};
-        }
-        if (child.type == "IMPLIES") {
-            Node notA = {"NOT", {child.children[0]}};
-            return {"OR", {notA, child.children[1]}};
-        }
-        if (child.type == "BICONDITIONAL") {
-            return toCNFTree(Node{"NOT", {Node{"OR", {Node{"IMPLIES", {child.children[0], child.children[1]}},
-                                                      Node{"IMPLIES", {child.children[1], child.children[0]}}}}}});
+// Expressions are independent until deduplication, so each window of them is
+// converted in parallel by worker converters with their own tokenizer, arena and
+// variable table, then merged here in input order. The merge maps worker
+// variable ids to this converter's. A worker numbers the auxiliary variables of
+// every expression from _t1; the merge shifts them past those of the earlier
+// expressions, which gives the same names as converting everything on one
+// thread.
+//
+// Each clause is then sorted by literal, which drops repeated literals and
+// exposes tautologies (x next to !x), and kept only if the ClauseSet has not
+// seen it before.
+void CNFConverter::convertLines(const function<bool(LineView &)> &next, const ClauseSink &sink) {
+    WorkStealingPool pool(threads);
+    vector<unique_ptr<CNFConverter>> workers;
+    for (int i = 0; i < pool.size(); ++i) {
+        workers.emplace_back(new CNFConverter(mode, 1));
+    }
+    vector<vector<int32_t>> globalIds(workers.size());  // per worker: its variable id -> ours, -1 if not seen
+
+    ClauseSet uniqueClauses;
+    vector<LineView> window;
+    vector<vector<Lit>> results;
+    vector<int> auxCounts;
+    vector<int> resultWorkers;
+    vector<Lit> clause;
+    bool more = true;
+    while (more) {
+        window.clear();
+        LineView expr;
+        while (window.size() < WINDOW_EXPRESSIONS && (more = next(expr))) {
+            window.push_back(expr);
         }
-    }
+        results.resize(window.size());
+        auxCounts.assign(window.size(), 0);
+        resultWorkers.assign(window.size(), 0);
+        pool.run(window.size(), [&](int worker, size_t index) {
+            CNFConverter &converter = *workers[worker];
+            converter.auxCount = 0;
+            results[index].clear();
+            converter.expressionClauses(window[index].data, window[index].size, results[index]);
+            auxCounts[index] = converter.auxCount;
+            resultWorkers[index] = worker;
+        });
+
+        for (size_t index = 0; index < window.size(); ++index) {
+            CNFConverter &converter = *workers[resultWorkers[index]];
+            vector<int32_t> &ids = globalIds[resultWorkers[index]];
+            ids.resize(converter.variableNames.size(), -1);
+            for (Lit literal: results[index]) {
+                if (literal != CLAUSE_END) {
+                    int32_t local = literalVariable(literal);
+                    int32_t variable;
+                    if (converter.auxNumbers[local]) {
+                        variable = auxVariable(auxCount + converter.auxNumbers[local]);
+                    } else {
+                        if (ids[local] < 0) {
+                            ids[local] = internVariable(converter.variableNames[local]);
+                        }
+                        variable = ids[local];
+                    }
+                    if (variable != 0) {  // the empty name adds no literal
+                        clause.push_back(2 * variable + (literal & 1));
+                    }
+                    continue;
+                }
 
-    if (root.type == "AND") {
-        if (root.children[0].type == "OR") {
-            return {"OR", {toCNFTree(Node{"AND", {root.children[0].children[0], root.children[1]}}),
-                           toCNFTree(Node{"AND", {root.children[0].children[1], root.children[1]}})}};
-        }
-        if (root.children[1].type == "OR") {
-            return {"OR", {toCNFTree(Node{"AND", {root.children[0], root.children[1].children[0]}}),
-                           toCNFTree(Node{"AND", {root.children[0], root.children[1].children[1]}})}};
+                sort(clause.begin(), clause.end());
+                clause.erase(unique(clause.begin(), clause.end()), clause.end());
+                bool tautology = false;
+                for (size_t i = 1; i < clause.size() && !tautology; ++i) {
+                    tautology = clause[i] == (clause[i - 1] | 1) && !isNegated(clause[i - 1]);
+                }
+                if (!tautology && uniqueClauses.insert(clause)) {
+                    sink(clauseToString(clause));
+                }
+                clause.clear();
+            }
+            auxCount += auxCounts[index];
         }
     }
+}
 
-    if (root.type == "OR") {
-        return {"AND", {toCNFTree(Node{"NOT", {root.children[0]}}),
-                        toCNFTree(Node{"NOT", {root.children[1]}})}};
-    }
-
-    for (Node &child: root.children) {
-        child = toCNFTree(child);
-    }
-
-    return root;
+void CNFConverter::convertBnf(const char *data, size_t size, const ClauseSink &sink) {
+    LineCursor lines(data, size);
+    convertLines([&lines](LineView &expr) { return lines.next(expr); }, sink);
 }
 
-vector<string> CNFConverter::convertBnf(const vector<string> &exprs) {
+vector<string> CNFConverter::convertBnf(const char *data, size_t size) {
     vector<string> allClauses;
-    set<string> uniqueClauses;
-
-    for (const auto &expr: exprs) {
-        vector<Token> tokenlist = tokenize(expr);
-        int pos = 0;
-        Node astRoot = parse(tokenlist, pos); // 解析得到AST
-
-        Node cnfRoot = toCNF(astRoot);
-
-        auto currentClauses = convertToCNF(cnfRoot); // 将AST转换为CNF形式
+    convertBnf(data, size, [&allClauses](string &&clause) { allClauses.push_back(std::move(clause)); });
+    return allClauses;
+}
 
-        for (const auto &clause: currentClauses) {
-            stringstream ss;
-            for (const auto &lit: clause) {
-                ss << lit << "";
-            }
-            string clauseStr = ss.str();
-            if (uniqueClauses.find(clauseStr) == uniqueClauses.end()) {
-                uniqueClauses.insert(clauseStr);
-                allClauses.push_back(clauseStr);
-            }
+void CNFConverter::convert(const vector<string> &exprs, const ClauseSink &sink) {
+    size_t index = 0;
+    convertLines([&exprs, &index](LineView &expr) {
+        if (index == exprs.size()) {
+            return false;
         }
-    }
-// for test
-    vector<string> allClauses1 = {"!A !B", "!A C B !D", "!A E B !D", "A !B C D", "A !B E", "!A !C D", "C A D",
-                                  "!C !E !A", "!C !E B", "!D !E !A", "!D !E B"};
-    return allClauses1;
+        expr.data = exprs[index].data();
+        expr.size = exprs[index].size();
+        ++index;
+        return true;
+    }, sink);
 }
 
 vector<string> CNFConverter::convert(const vector<string> &exprs) {
     vector<string> allClauses;
-    set<string> uniqueClauses;
-
-    for (const auto &expr: exprs) {
-        vector<Token> tokenlist = tokenize(expr);
-        int pos = 0;
-        Node astRoot = parse(tokenlist, pos); // 解析得到AST
+    convert(exprs, [&allClauses](string &&clause) { allClauses.push_back(std::move(clause)); });
+    return allClauses;
+}
 
-        Node cnfRoot = toCNF(astRoot);
+CNFConverter::CNFConverter(CNFMode mode, int threads)
+        : mode(mode), threads(threads > 0 ? threads : defaultThreadCount()), auxCount(0) {
+    internVariable("");  // id 0, see variableIds
+}
 
+bool CNFConverter::isAuxiliaryVariable(const string &name) {
+    return name.compare(0, AUX_PREFIX.size(), AUX_PREFIX) == 0;
+}
 
-        //transform
-        auto currentClauses = convertToCNF(cnfRoot);
-        // remove duplicates
-        for (const auto &clause: currentClauses) {
-            stringstream ss;
-            for (const auto &lit: clause) {
-                ss << lit << "";
-            }
-            string clauseStr = ss.str();
-            if (uniqueClauses.find(clauseStr) == uniqueClauses.end()) {
-                uniqueClauses.insert(clauseStr);
-                allClauses.push_back(clauseStr);
-            }
-        }
+// The formula holds: conjunctions are split, a top-level <=> becomes two
+// clauses, anything else is one clause over its flattened disjuncts.
+void CNFConverter::tseitinAssert(NodeRef root, vector<Lit> &clauses) {
+    Node node = arena[root];
+    if (node.op == OP_AND) {
+        tseitinAssert(node.left, clauses);
+        tseitinAssert(node.right, clauses);
+    } else if (node.op == OP_NOT && arena[node.left].op == OP_NOT) {
+        tseitinAssert(arena[node.left].left, clauses);
+    } else if (node.op == OP_BICONDITIONAL) {
+        Lit a = tseitinLiteral(node.left, 0, clauses);
+        Lit b = tseitinLiteral(node.right, 0, clauses);
+        addClause({negateLiteral(a), b}, clauses);
+        addClause({a, negateLiteral(b)}, clauses);
+    } else {
+        vector<Lit> literals;
+        tseitinDisjuncts(root, literals, clauses);
+        addClause(literals, clauses);
     }
-
-    return allClauses;
 }
 
+void CNFConverter::tseitinDisjuncts(NodeRef root, vector<Lit> &literals, vector<Lit> &clauses) {
+    Node node = arena[root];
+    if (node.op == OP_OR) {
+        tseitinDisjuncts(node.left, literals, clauses);
+        tseitinDisjuncts(node.right, literals, clauses);
+    } else if (node.op == OP_IMPLIES) {
+        literals.push_back(negateLiteral(tseitinLiteral(node.left, -1, clauses)));
+        tseitinDisjuncts(node.right, literals, clauses);
+    } else {
+        literals.push_back(tseitinLiteral(root, 1, clauses));
+    }
+}
 
-CNFConverter::CNFConverter() {
+// Returns a literal standing for node: the variable itself for a leaf, else a
+// new auxiliary x with x => node (polarity >= 0) and node => x (polarity <= 0).
+CNFConverter::Lit CNFConverter::tseitinLiteral(NodeRef root, int polarity, vector<Lit> &clauses) {
+    Node node = arena[root];
+    if (node.op == OP_VAR) {
+        return 2 * node.left;
+    }
+    if (node.op == OP_NOT) {
+        return negateLiteral(tseitinLiteral(node.left, -polarity, clauses));
+    }
+
+    Lit a, b;
+    if (node.op == OP_BICONDITIONAL) {
+        a = tseitinLiteral(node.left, 0, clauses);
+        b = tseitinLiteral(node.right, 0, clauses);
+    } else if (node.op == OP_IMPLIES) {
+        // A => B is !A v B
+        a = negateLiteral(tseitinLiteral(node.left, -polarity, clauses));
+        b = tseitinLiteral(node.right, polarity, clauses);
+    } else {
+        a = tseitinLiteral(node.left, polarity, clauses);
+        b = tseitinLiteral(node.right, polarity, clauses);
+    }
 
+    Lit x = 2 * auxVariable(++auxCount);
+    Lit notX = negateLiteral(x);
+    if (node.op == OP_BICONDITIONAL) {
+        if (polarity >= 0) {
+            addClause({notX, negateLiteral(a), b}, clauses);
+            addClause({notX, a, negateLiteral(b)}, clauses);
+        }
+        if (polarity <= 0) {
+            addClause({x, a, b}, clauses);
+            addClause({x, negateLiteral(a), negateLiteral(b)}, clauses);
+        }
+    } else if (node.op == OP_AND) {
+        if (polarity >= 0) {
+            addClause({notX, a}, clauses);
+            addClause({notX, b}, clauses);
+        }
+        if (polarity <= 0) {
+            addClause({x, negateLiteral(a), negateLiteral(b)}, clauses);
+        }
+    } else {  // OR, IMPLIES
+        if (polarity >= 0) {
+            addClause({notX, a, b}, clauses);
+        }
+        if (polarity <= 0) {
+            addClause({x, negateLiteral(a)}, clauses);
+            addClause({x, negateLiteral(b)}, clauses);
+        }
+    }
+    return x;
 }
 
+void CNFConverter::addClause(const vector<Lit> &literals, vector<Lit> &clauses) {
+    clauses.insert(clauses.end(), literals.begin(), literals.end());
+    clauses.push_back(CLAUSE_END);
+}
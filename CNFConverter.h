@@ -5,9 +5,29 @@
 #ifndef AILAB2_CNFCONVERTER_H
 #define AILAB2_CNFCONVERTER_H
 
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include "InputFile.h"
 using namespace std;
+
+// Converts propositional formulas ("A ^ B => !C", Sudoku names such as
+// n5_r3_c7) into clauses, one string of space-separated literals per clause.
+//
+// CNF_DISTRIBUTE rewrites each formula into an equivalent CNF by distributing OR
+// over AND, which can blow up exponentially on nested formulas. CNF_TSEITIN
+// instead names every compound subformula with an auxiliary variable
+// (Plaisted-Greenbaum: only the implications the subformula's polarity needs),
+// which keeps the clause count linear. The result is equisatisfiable, and its
+// models restricted to the original variables are exactly the formula's models;
+// isAuxiliaryVariable() tells the extra variables apart.
+enum CNFMode {
+    CNF_DISTRIBUTE,
+    CNF_TSEITIN,
+};
+
 class CNFConverter {
 private:
     enum TokenType {
@@ -21,81 +41,106 @@ private:
         CLOSE_PAREN,
     };
 
+    // A token is a view into the expression text (for -bnf, the mapped input
+    // file); variable names are only copied when first interned.
     struct Token {
         Token() {};
         TokenType type;
-        string value;
-        Token(TokenType t, string v);
+        const char *text;
+        size_t length;
+        Token(TokenType t, const char *text, size_t length);
     };
 
-    vector<Token> tokens;
-    int currentPosition;
-    Token currentToken;
-    vector<Token> tokenize(const string& expr);
-
-
-
+    // The syntax tree of one expression. Nodes live in a bump arena that is
+    // emptied (keeping its capacity) before each expression and refer to their
+    // operands by index, so rewrites build new nodes over shared subtrees
+    // instead of copying them.
+    enum NodeOp : uint8_t {
+        OP_VAR,
+        OP_NOT,
+        OP_AND,
+        OP_OR,
+        OP_IMPLIES,
+        OP_BICONDITIONAL,
+    };
 
-public:
-    CNFConverter();
+    using NodeRef = int32_t;
 
-    vector<string> convert(const vector<string>& exprs);
     struct Node {
-        string type;
-        vector<Node> children;
-
-        Node() = default;
-        Node(const string& type, const vector<Node>& children = {})
-                : type(type), children(children) {}
+        NodeOp op;
+        int32_t left;   // OP_VAR: variable id; OP_NOT: the operand
+        int32_t right;  // unused for OP_VAR and OP_NOT
     };
 
-
-
-    Node parse(const vector<Token>& tokens, int& pos);
-    vector<string> convertToCNF(Node& root);
-
-
-
-    string tokenToString(const Token &token);
-
-    void printTree(const Node &node, int level);
-
-    void traverse(const Node &node);
-
-    Node toCNF(const Node &node);
-
-    string tokenTypeToString(TokenType type);
-
+    vector<Node> arena;
+    vector<Token> tokens;  // of the current expression, reused like arena
+
+    // Variable names seen so far, shared by every expression of the converter.
+    // Id 0 is the empty name, which stands in for unparsable input.
+    unordered_map<string, int32_t> variableIds;
+    vector<string> variableNames;
+    vector<int32_t> auxNumbers;  // per variable id: K for the auxiliary _tK, else 0
+    vector<int32_t> auxIds;      // K -> variable id of _tK
+    string nameBuffer;           // lookup key for internVariable(), keeps its capacity
+
+    // Clauses are built as literals 2 * variable id + (1 if negated) and kept in
+    // flat lists, each clause ended by CLAUSE_END; strings are only made for the
+    // clauses that survive deduplication.
+    using Lit = int32_t;
+    static const Lit CLAUSE_END = -1;
+
+    CNFMode mode;
+    int threads;
+    int auxCount;  // auxiliary variables created so far (CNF_TSEITIN)
+
+    void tokenize(const char *expr, size_t length, vector<Token> &tokens);
+    void expressionClauses(const char *expr, size_t length, vector<Lit> &clauses);
+    void convertLines(const function<bool(LineView &)> &next, const function<void(string &&)> &sink);
+    bool literalBefore(Lit a, Lit b) const;
+    string clauseToString(vector<Lit> &clause);
+
+    int32_t internVariable(const string &name);
+    int32_t internVariable(const char *name, size_t length);
+    int32_t auxVariable(int32_t number);
+    NodeRef makeNode(NodeOp op, NodeRef left, NodeRef right = -1);
+    NodeRef makeVariable(const char *name, size_t length = 0);
+    bool isLeaf(NodeRef node) const;
+
+    NodeRef parse(const vector<Token> &tokens, int &pos);
     int precedence(TokenType op);
+    string tokenToString(const Token &token);
+    NodeOp tokenOperator(TokenType type);
 
+    NodeRef toCNF(NodeRef node, bool negated = false);
+    NodeRef distributeOr(NodeRef left, NodeRef right);
+    void convertToCNF(NodeRef root, vector<Lit> &clauses);
+    void collectDisjuncts(NodeRef root, vector<Lit> &literals);
 
-    void printAST(const Node &node, int indent);
-
-
-    string extractLiteral(const Node &node);
-
-    void printCNF(const Node &node, bool newClause);
-
-    Node simplifyCNF(const Node &node);
-
-    void printTree(const Node &node, string prefix);
-
-
-    Node factor(const vector<Token> &tokens, int &pos);
-
-    Node expression(const vector<Token> &tokens, int &pos);
+    // CNF_TSEITIN. polarity is +1 where a subformula occurs positively, -1 where
+    // negated and 0 under <=>.
+    void tseitinAssert(NodeRef node, vector<Lit> &clauses);
+    void tseitinDisjuncts(NodeRef node, vector<Lit> &literals, vector<Lit> &clauses);
+    Lit tseitinLiteral(NodeRef node, int polarity, vector<Lit> &clauses);
+    void addClause(const vector<Lit> &literals, vector<Lit> &clauses);
 
-    Node and_expression(const vector<Token> &tokens, int &pos);
+    void printTree(NodeRef node, const string &prefix);
 
-    Node implies_expression(const vector<Token> &tokens, int &pos);
+public:
+    // Receives each clause as soon as it is produced, in output order.
+    using ClauseSink = function<void(string &&clause)>;
 
-    void simplifyDoubleNegation(Node &root);
+    // Expressions are converted on up to threads threads (0: one per core);
+    // the clauses come out in the same order either way.
+    explicit CNFConverter(CNFMode mode = CNF_DISTRIBUTE, int threads = 0);
 
-    Node toCNFTree(Node root);
+    static bool isAuxiliaryVariable(const string &name);
 
-    string nodeToString(const Node &root);
+    vector<string> convert(const vector<string>& exprs);
+    void convert(const vector<string>& exprs, const ClauseSink &sink);
 
-    vector<string> convertBnf(const vector<string> &exprs);
+    // One expression per line of the buffer, e.g. a mapped InputFile.
+    vector<string> convertBnf(const char *data, size_t size);
+    void convertBnf(const char *data, size_t size, const ClauseSink &sink);
 };
 
 
@@ -0,0 +1,63 @@
+#include "ClauseExchange.h"
+
+const int ClauseExchange::MAX_LENGTH;
+
+ClauseExchange::ClauseExchange(size_t capacity) : capacity(capacity), slots(new Slot[capacity]), head(0) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(0, memory_order_relaxed);
+        slots[i].source.store(-1, memory_order_relaxed);
+        slots[i].length.store(0, memory_order_relaxed);
+    }
+}
+
+bool ClauseExchange::publish(int source, const IntClause &clause) {
+    if (clause.empty() || clause.size() > static_cast<size_t>(MAX_LENGTH)) {
+        return false;
+    }
+    uint64_t index = head.fetch_add(1, memory_order_relaxed);
+    Slot &slot = slots[index % capacity];
+
+    // Claim the slot unless another writer holds it or already put a newer clause there.
+    uint64_t current = slot.sequence.load(memory_order_relaxed);
+    if ((current & 1) || current > 2 * index ||
+        !slot.sequence.compare_exchange_strong(current, 2 * index + 1, memory_order_acquire)) {
+        return false;
+    }
+    // Keeps the data stores below from becoming visible before the odd sequence;
+    // without it a reader on ARM could pair the old even sequence with new data.
+    // x86 never reorders stores, so the tests cannot catch a missing fence.
+    atomic_thread_fence(memory_order_release);
+    slot.source.store(source, memory_order_relaxed);
+    slot.length.store(static_cast<int>(clause.size()), memory_order_relaxed);
+    for (size_t i = 0; i < clause.size(); ++i) {
+        slot.lits[i].store(clause[i], memory_order_relaxed);
+    }
+    slot.sequence.store(2 * index + 2, memory_order_release);
+    return true;
+}
+
+void ClauseExchange::collect(int reader, uint64_t &cursor, vector<IntClause> &out) {
+    uint64_t end = head.load(memory_order_acquire);
+    if (end - cursor > capacity) {
+        cursor = end - capacity;
+    }
+    for (; cursor < end; ++cursor) {
+        Slot &slot = slots[cursor % capacity];
+        uint64_t complete = 2 * cursor + 2;
+        if (slot.sequence.load(memory_order_acquire) != complete) {
+            continue;
+        }
+        int source = slot.source.load(memory_order_relaxed);
+        int length = slot.length.load(memory_order_relaxed);
+        IntClause clause;
+        for (int i = 0; i < length && i < MAX_LENGTH; ++i) {
+            clause.push_back(slot.lits[i].load(memory_order_relaxed));
+        }
+        // Anything read above is only trustworthy if nobody reclaimed the slot meanwhile.
+        atomic_thread_fence(memory_order_acquire);
+        if (slot.sequence.load(memory_order_relaxed) != complete || source == reader) {
+            continue;
+        }
+        out.push_back(clause);
+    }
+}
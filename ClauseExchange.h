@@ -0,0 +1,45 @@
+#ifndef AILAB2_CLAUSEEXCHANGE_H
+#define AILAB2_CLAUSEEXCHANGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "DPLL.h"
+
+using namespace std;
+
+// Lock-free buffer through which portfolio solvers pass short learned clauses.
+// It is a fixed ring of slots: publish() claims the next slot with a fetch_add
+// and overwrites whatever clause was there. Every reader keeps its own cursor;
+// clauses overwritten or still being written when a reader gets to them are
+// skipped, so the exchange may lose clauses but never blocks and never hands
+// out a torn one (each slot is guarded by a sequence number, seqlock style).
+class ClauseExchange {
+public:
+    static const int MAX_LENGTH = 8;
+
+private:
+    struct Slot {
+        atomic<uint64_t> sequence;  // 2i+1 while clause i is written, 2i+2 once it is complete
+        atomic<int> source;
+        atomic<int> length;
+        atomic<int> lits[MAX_LENGTH];
+    };
+
+    size_t capacity;
+    unique_ptr<Slot[]> slots;
+    atomic<uint64_t> head;  // number of publish() calls so far
+
+public:
+    explicit ClauseExchange(size_t capacity = 4096);
+
+    // Returns false if the clause is too long or its slot was busy.
+    bool publish(int source, const IntClause &clause);
+
+    // Appends the clauses published by other sources since cursor to out and
+    // moves cursor to the end. A new reader starts with cursor 0.
+    void collect(int reader, uint64_t &cursor, vector<IntClause> &out);
+};
+
+#endif //AILAB2_CLAUSEEXCHANGE_H
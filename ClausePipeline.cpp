@@ -0,0 +1,42 @@
+#include "ClausePipeline.h"
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+
+namespace {
+    const size_t BATCH_CLAUSES = 4096;
+    const size_t QUEUE_BATCHES = 8;
+}
+
+void streamClauses(const function<void(const CNFConverter::ClauseSink &)> &produce, VariableTable &variables,
+                   IntFormula &formula, const function<void(const string &)> &onClause) {
+    BoundedQueue<vector<string>> queue(QUEUE_BATCHES);
+
+    thread producer([&produce, &queue]() {
+        vector<string> batch;
+        batch.reserve(BATCH_CLAUSES);
+        produce([&batch, &queue](string &&clause) {
+            batch.push_back(std::move(clause));
+            if (batch.size() == BATCH_CLAUSES) {
+                queue.push(std::move(batch));
+                batch = vector<string>();
+                batch.reserve(BATCH_CLAUSES);
+            }
+        });
+        if (!batch.empty()) {
+            queue.push(std::move(batch));
+        }
+        queue.close();
+    });
+
+    vector<string> batch;
+    while (queue.pop(batch)) {
+        for (const string &clause: batch) {
+            if (onClause) {
+                onClause(clause);
+            }
+            formula.push_back(variables.internClause(clause));
+        }
+    }
+    producer.join();
+}
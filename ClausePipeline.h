@@ -0,0 +1,22 @@
+#ifndef AILAB2_CLAUSEPIPELINE_H
+#define AILAB2_CLAUSEPIPELINE_H
+
+#include <functional>
+#include <string>
+#include "CNFConverter.h"
+#include "DPLL.h"
+#include "VariableTable.h"
+
+// Overlaps conversion with loading the solver input. produce() runs on its own
+// thread and hands clause strings to the sink it is given; they travel in
+// batches through a bounded queue to the calling thread, which turns each one
+// into an IntClause (interning its variables) and appends it to formula. Only a
+// few batches are in flight at a time, so the clause strings are never all held
+// at once. onClause, if set, sees each clause string first, in order (for -v).
+//
+// Clauses and variable ids come out exactly as if the whole output of produce()
+// had been collected first and passed to VariableTable::internFormula().
+void streamClauses(const function<void(const CNFConverter::ClauseSink &)> &produce, VariableTable &variables,
+                   IntFormula &formula, const function<void(const string &)> &onClause = nullptr);
+
+#endif //AILAB2_CLAUSEPIPELINE_H
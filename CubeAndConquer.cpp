@@ -0,0 +1,160 @@
+#include "CubeAndConquer.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include "Solver.h"
+#include "ThreadPool.h"
+
+// Open variables probed per lookahead node.
+static const int LOOKAHEAD_CANDIDATES = 32;
+
+namespace {
+    struct Cuber {
+        Solver &solver;
+        const vector<int> &candidates;  // variables by descending occurrence count
+        vector<Literal> path;
+        vector<vector<Literal>> cubes;
+
+        // budget is the number of cubes this node may produce.
+        void split(size_t budget) {
+            size_t asserted = 0;
+            bool refuted = false;
+            int best = 0;
+            bool rescan = true;
+            while (rescan) {
+                rescan = false;
+                best = 0;
+                long long bestScore = -1;
+                int probed = 0;
+                for (size_t i = 0; i < candidates.size() && probed < LOOKAHEAD_CANDIDATES; ++i) {
+                    int var = candidates[i];
+                    if (solver.isAssigned(var)) {
+                        continue;
+                    }
+                    probed++;
+                    int positive = solver.probe(var);
+                    solver.popLevel();
+                    int negative = solver.probe(-var);
+                    solver.popLevel();
+
+                    if (positive < 0 && negative < 0) {
+                        refuted = true;  // both values fail: no model below this node
+                        break;
+                    }
+                    if (positive < 0 || negative < 0) {
+                        // Failed literal: the other value is implied. Assert it and scan again.
+                        Literal implied = positive < 0 ? -var : var;
+                        solver.probe(implied);
+                        path.push_back(implied);
+                        asserted++;
+                        rescan = true;
+                        break;
+                    }
+                    long long score = static_cast<long long>(positive + 1) * (negative + 1);
+                    if (score > bestScore) {
+                        best = var;
+                        bestScore = score;
+                    }
+                }
+            }
+
+            if (!refuted) {
+                if (best == 0 || budget <= 1) {
+                    cubes.push_back(path);
+                } else {
+                    for (Literal lit: {best, -best}) {
+                        if (solver.probe(lit) >= 0) {
+                            path.push_back(lit);
+                            split(budget / 2);
+                            path.pop_back();
+                        }
+                        solver.popLevel();
+                    }
+                }
+            }
+            for (; asserted > 0; --asserted) {
+                path.pop_back();
+                solver.popLevel();
+            }
+        }
+    };
+}
+
+vector<vector<Literal>> makeCubes(const IntFormula &formula, int numVars, int maxCubes) {
+    Solver solver(numVars);
+    vector<int> occurrences(numVars + 1, 0);
+    for (const IntClause &clause: formula) {
+        if (!solver.addClause(clause)) {
+            return vector<vector<Literal>>();
+        }
+        for (Literal lit: clause) {
+            occurrences[abs(lit)]++;
+        }
+    }
+
+    vector<int> candidates;
+    for (int var = 1; var <= numVars; ++var) {
+        if (occurrences[var] > 0) {
+            candidates.push_back(var);
+        }
+    }
+    stable_sort(candidates.begin(), candidates.end(), [&occurrences](int a, int b) {
+        return occurrences[a] > occurrences[b];
+    });
+
+    Cuber cuber{solver, candidates, vector<Literal>(), vector<vector<Literal>>()};
+    cuber.split(static_cast<size_t>(max(maxCubes, 1)));
+    return cuber.cubes;
+}
+
+Model solveCubeAndConquer(const IntFormula &formula, int numVars, const SolverOptions &options, int threads,
+                          int maxCubes, SolverStats *stats, size_t *cubeCount) {
+    vector<vector<Literal>> cubes = makeCubes(formula, numVars, maxCubes);
+    if (cubeCount) {
+        *cubeCount = cubes.size();
+    }
+
+    WorkStealingPool pool(threads);
+    vector<unique_ptr<Solver>> solvers;
+    atomic<bool> stop(false);
+    for (int worker = 0; worker < pool.size(); ++worker) {
+        solvers.emplace_back(new Solver(numVars, options));
+        solvers.back()->setCancelFlag(&stop);
+        for (const IntClause &clause: formula) {
+            if (!solvers.back()->addClause(clause)) {
+                break;
+            }
+        }
+    }
+
+    mutex resultLock;
+    Model result;
+    pool.run(cubes.size(), [&](int worker, size_t cube) {
+        if (stop.load(memory_order_relaxed)) {
+            return;
+        }
+        Solver &solver = *solvers[worker];
+        if (solver.solve(cubes[cube]) && !solver.interrupted()) {
+            lock_guard<mutex> guard(resultLock);
+            if (!stop.load(memory_order_relaxed)) {
+                result = solver.model();
+                stop.store(true, memory_order_relaxed);
+            }
+        }
+    });
+
+    if (stats) {
+        *stats = SolverStats();
+        for (const unique_ptr<Solver> &solver: solvers) {
+            const SolverStats &s = solver->stats();
+            stats->decisions += s.decisions;
+            stats->propagations += s.propagations;
+            stats->conflicts += s.conflicts;
+            stats->learnedClauses += s.learnedClauses;
+            stats->deletedClauses += s.deletedClauses;
+            stats->restarts += s.restarts;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,25 @@
+#ifndef AILAB2_CUBEANDCONQUER_H
+#define AILAB2_CUBEANDCONQUER_H
+
+#include "DPLL.h"
+
+// Cube and conquer: a lookahead pass splits the formula into cubes (sets of
+// assumption literals) whose sub-problems together cover the search space, then
+// worker threads solve the cubes under those assumptions.
+
+// Lookahead splitting. At each node the most frequent open variables are probed
+// both ways and the one whose two branches assign the most literals (product of
+// the two counts) is split on; a literal whose probe fails is asserted instead.
+// Branches refuted by propagation produce no cube, so an empty result means the
+// formula is unsatisfiable. Stops splitting at about maxCubes cubes.
+vector<vector<Literal>> makeCubes(const IntFormula &formula, int numVars, int maxCubes);
+
+// Solves the cubes on threads workers, each with its own Solver that keeps its
+// learned clauses from one cube to the next. Cubes are handed out through a
+// WorkStealingPool. The first satisfiable cube stops the run and its model is
+// returned; an empty model means every cube was refuted. stats sums the
+// workers' counters.
+Model solveCubeAndConquer(const IntFormula &formula, int numVars, const SolverOptions &options, int threads,
+                          int maxCubes, SolverStats *stats = nullptr, size_t *cubeCount = nullptr);
+
+#endif //AILAB2_CUBEANDCONQUER_H
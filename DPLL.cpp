@@ -4,124 +4,58 @@
 #include <set>
 #include <algorithm>
 #include <fstream>
+#include "DPLL.h"
+#include "Solver.h"
+#include "VariableTable.h"
 
 using namespace std;
-using Clause = vector<string>;
-using Formula = vector<Clause>;
-using Assignment = map<string, bool>;
 
-Formula applyAssignmentToFormula(const Formula &formula, const string &var, bool val) {
-    Formula newFormula;
-    for (const Clause &clause: formula) {
-        bool skipClause = false;
-        Clause newClause;
-        for (const string &literal: clause) {
-            string literalVar = literal[0] != '!' ? literal : literal.substr(1);
-            if (literalVar == var) {
-                // 如果文字被评估为真
-                if ((literal[0] != '!' && val) || (literal[0] == '!' && !val)) {
-                    // 整个子句也被评估为真，所以我们跳过整个子句
-                    skipClause = true;
-                    break;
-                }
-                // 对于被评估为假的文字，仅删除文字
-                continue;
-            }
-            newClause.push_back(literal);
-        }
-        if (!skipClause) {
-            newFormula.push_back(newClause);
+Model dpll(const IntFormula &formula, int numVars, const SolverOptions &options, SolverStats *stats) {
+    Solver solver(numVars, options);
+    bool satisfiable = true;
+    for (const IntClause &clause: formula) {
+        if (!solver.addClause(clause)) {
+            satisfiable = false;  // Empty clause found, unsatisfiable
+            break;
         }
     }
-    return newFormula;
-}
-
-
-string getVariableForSplit(const Formula &formula) {
-    if (!formula.empty() && !formula[0].empty()) {
-        string literal = formula[0][0];
-        return literal[0] != '!' ? literal : literal.substr(1);
+    satisfiable = satisfiable && solver.solve();
+    if (stats) {
+        *stats = solver.stats();
     }
-    return "";
-}
-
-Assignment handleUnitClauses(const Formula &formula, const Assignment &assignments) {
-    Assignment newAssignments = assignments;
-    bool changesMade = false;
-
-    for (size_t i = 0; i < formula.size(); i++) {
-        if (formula[i].size() == 1) {
-            string literal = formula[i][0];
-            bool val = literal[0] != '!';
-            string var = val ? literal : literal.substr(1);
-
-            if (assignments.find(var) == assignments.end()) {
-                newAssignments[var] = val;
-                changesMade = true;
-            } else if (assignments.at(var) != val) {
-                return {};  // Conflict detected
-            }
-        }
+    if (!satisfiable) {
+        return {};
     }
-
-    return changesMade ? newAssignments : assignments;
+    return solver.model();
 }
 
+void printStats(const SolverStats &stats, ostream &out) {
+    out << "decisions: " << stats.decisions << endl;
+    out << "propagations: " << stats.propagations << endl;
+    out << "conflicts: " << stats.conflicts << endl;
+    out << "learned clauses: " << stats.learnedClauses << endl;
+    out << "deleted clauses: " << stats.deletedClauses << endl;
+    out << "restarts: " << stats.restarts << endl;
+    out << "imported clauses: " << stats.importedClauses << endl;
+    out << "pure literals: " << stats.pureLiterals << endl;
+    out << "probes: " << stats.probes << endl;
+    out << "failed literals: " << stats.failedLiterals << endl;
+    out << "necessary assignments: " << stats.necessaryAssignments << endl;
+}
 
-
-Assignment dpll(const Formula &formula, const Assignment &initialAssignments) {
-    // Base cases
-    if (formula.empty()) {
-        return initialAssignments;  // Satisfiable with current assignments
-    }
-
-    if (any_of(formula.begin(), formula.end(), [](const Clause &clause) { return clause.empty(); })) {
-        return {};  // Empty clause found, unsatisfiable
-    }
-
-    // Apply unit clause rule
-    for (size_t i = 0; i < formula.size(); i++) {
-        if (formula[i].size() == 1) {
-            string literal = formula[i][0];
-            bool val;
-            string var;
-            if (literal[0] == '!') {
-                val = false;   // This is a negation, so we assign the opposite
-                var = literal.substr(1);
-            } else {
-                val = true;
-                var = literal;
-            }
-
-
-            Assignment newAssignments = initialAssignments;
-            newAssignments[var] = val;
-
-            // Update the formula according to the assignment
-            Formula updatedFormula = applyAssignmentToFormula(formula, var, val);
-            return dpll(updatedFormula, newAssignments);
-        }
-    }
-
-    // Apply split rule
-    string splitVar = getVariableForSplit(formula);
-    if (initialAssignments.find(splitVar) != initialAssignments.end()) {
-        return {};  // We shouldn't split on a variable that already has an initial value
+// String front end kept for existing callers: names are interned once, the search
+// runs on integer literals and the result is mapped back to names at the end.
+Assignment dpll(const Formula &formula, const Assignment &initialAssignments, const SolverOptions &options) {
+    VariableTable variables;
+    IntFormula intFormula = variables.internFormula(formula);
+    for (const auto &pair: initialAssignments) {
+        int var = variables.intern(pair.first);
+        intFormula.push_back({pair.second ? var : -var});
     }
 
-    Assignment trueAssignment = initialAssignments;
-    trueAssignment[splitVar] = true;
-
-    Formula trueFormula = applyAssignmentToFormula(formula, splitVar, true);
-    Assignment result = dpll(trueFormula, trueAssignment);
-
-    if (!result.empty()) {
-        return result;
+    Model model = dpll(intFormula, variables.size(), options);
+    if (model.empty()) {
+        return {};
     }
-
-    Assignment falseAssignment = initialAssignments;
-    falseAssignment[splitVar] = false;
-    Formula falseFormula = applyAssignmentToFormula(formula, splitVar, false);
-    return dpll(falseFormula, falseAssignment);
+    return variables.toAssignment(model);
 }
-
@@ -12,12 +12,93 @@
 #include <string>
 #include <algorithm>
 #include <stack>
+#include <cstdint>
+
+using namespace std;
+
 using Clause = vector<string>;
 using Formula = vector<Clause>;
 using Assignment = map<string, bool>;
 
-using namespace std;
+// Integer form used by the solver: variables are ids 1..numVars (see VariableTable),
+// a literal is +id or -id.
+using Literal = int;
+using IntClause = vector<Literal>;
+using IntFormula = vector<IntClause>;
+
+// Model[var] holds the value of var; index 0 is unused. An empty Model means UNSAT.
+using Model = vector<int8_t>;
+const int8_t VAL_TRUE = 1;
+const int8_t VAL_FALSE = -1;
+const int8_t VAL_UNASSIGNED = 0;
+
+enum SearchMode {
+    MODE_DPLL,  // chronological backtracking
+    MODE_CDCL,  // clause learning with non-chronological backjumping
+};
+
+enum BranchHeuristic {
+    HEURISTIC_FIRST,  // first open literal of the first unsatisfied clause
+    HEURISTIC_VSIDS,  // highest conflict activity, with phase saving
+    HEURISTIC_MRV,    // group (Sudoku cell) with the fewest open candidates
+};
+
+// Restarts only apply to MODE_CDCL; the learned clauses keep it complete.
+enum RestartPolicy {
+    RESTART_NONE,
+    RESTART_LUBY,     // after lubyUnit * luby(i) conflicts
+    RESTART_GLUCOSE,  // when the recent LBD average rises above the long-term one
+};
+
+// Value tried first for a variable that has no saved phase (or always, without
+// phase saving).
+enum InitialPhase {
+    PHASE_TRUE,
+    PHASE_FALSE,
+    PHASE_RANDOM,  // drawn from seed
+};
+
+struct SolverOptions {
+    SearchMode mode = MODE_DPLL;
+    BranchHeuristic heuristic = HEURISTIC_VSIDS;
+    bool phaseSaving = true;
+    InitialPhase phase = PHASE_TRUE;
+    unsigned seed = 0;  // nonzero: seeds PHASE_RANDOM and tiny random initial VSIDS activities
+    double varDecay = 0.95;
+    // For HEURISTIC_MRV: sets of variables of which exactly one must be true,
+    // e.g. the nine candidates of a Sudoku cell. Without groups MRV behaves like VSIDS.
+    vector<IntClause> mrvGroups;
+    RestartPolicy restart = RESTART_LUBY;
+    int lubyUnit = 100;
+    double restartMargin = 1.25;  // glucose: restart when fast EMA > margin * slow EMA
+    int restartMinConflicts = 50;  // glucose: conflicts between two restarts
+    // Simplification during the search (see Solver.h).
+    bool pureLiterals = false;  // set literals whose negation occurs in no open clause
+    bool probing = false;       // failed-literal probing and lookahead below the assumptions
+    int probeLevels = 0;        // probe again at nodes up to this many levels deeper
+    long long probeBudget = 200000;  // propagations per probing pass
+};
+
+struct SolverStats {
+    long long decisions = 0;
+    long long propagations = 0;
+    long long conflicts = 0;
+    long long learnedClauses = 0;
+    long long deletedClauses = 0;
+    long long restarts = 0;
+    long long importedClauses = 0;  // received from other portfolio solvers
+    long long pureLiterals = 0;
+    long long probes = 0;
+    long long failedLiterals = 0;        // probes that ended in a conflict
+    long long necessaryAssignments = 0;  // implied by both values of a probed variable
+};
+
+void printStats(const SolverStats &stats, ostream &out);
+
 
+Model dpll(const IntFormula &formula, int numVars, const SolverOptions &options = SolverOptions(),
+           SolverStats *stats = nullptr);
 
-Assignment dpll(const Formula &formula, const Assignment &assignments);
+Assignment dpll(const Formula &formula, const Assignment &assignments,
+                const SolverOptions &options = SolverOptions());
 #endif //DPLL_H
@@ -0,0 +1,178 @@
+#include "Dimacs.h"
+#include <climits>
+#include "InputFile.h"
+
+namespace {
+    // The solver indexes literals as 2 * var (+1) in int, up to 2 * (numVars + 1).
+    const long long MAX_DIMACS_VARS = (INT_MAX >> 1) - 1;
+
+    // Cursor over the input that keeps the line number for error messages.
+    struct DimacsReader {
+        const char *pos;
+        const char *end;
+        long long line;
+
+        bool atEnd() const {
+            return pos == end;
+        }
+
+        void skipLine() {
+            while (pos != end && *pos != '\n') {
+                ++pos;
+            }
+        }
+
+        void skipSpace() {
+            while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) {
+                if (*pos == '\n') {
+                    ++line;
+                }
+                ++pos;
+            }
+        }
+
+        // Reads an optionally signed decimal; false if there is none.
+        bool readInt(long long &value) {
+            bool negative = false;
+            if (pos != end && (*pos == '-' || *pos == '+')) {
+                negative = *pos == '-';
+                ++pos;
+            }
+            if (pos == end || *pos < '0' || *pos > '9') {
+                return false;
+            }
+            value = 0;
+            while (pos != end && *pos >= '0' && *pos <= '9') {
+                value = value * 10 + (*pos - '0');
+                if (value > 0x7fffffff) {
+                    return false;
+                }
+                ++pos;
+            }
+            if (negative) {
+                value = -value;
+            }
+            return true;
+        }
+
+        bool readWord(const char *word) {
+            for (; *word; ++word, ++pos) {
+                if (pos == end || *pos != *word) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
+
+bool parseDimacs(const char *data, size_t size, IntFormula &formula, int &numVars) {
+    DimacsReader reader{data, data + size, 1};
+    long long declaredClauses = -1;
+    numVars = -1;
+    formula.clear();
+    IntClause clause;
+
+    while (true) {
+        reader.skipSpace();
+        if (reader.atEnd()) {
+            break;
+        }
+        char c = *reader.pos;
+        if (c == 'c') {
+            reader.skipLine();
+        } else if (c == '%') {
+            break;
+        } else if (c == 'p') {
+            long long vars = 0, count = 0;
+            reader.pos++;
+            reader.skipSpace();
+            bool ok = numVars < 0 && reader.readWord("cnf");
+            reader.skipSpace();
+            ok = ok && reader.readInt(vars) && vars >= 0;
+            reader.skipSpace();
+            ok = ok && reader.readInt(count) && count >= 0;
+            if (!ok) {
+                cerr << "DIMACS line " << reader.line << ": expected a single \"p cnf <vars> <clauses>\" header"
+                     << endl;
+                return false;
+            }
+            if (vars > MAX_DIMACS_VARS) {
+                cerr << "DIMACS line " << reader.line << ": " << vars << " variables exceed the limit of "
+                     << MAX_DIMACS_VARS << endl;
+                return false;
+            }
+            numVars = static_cast<int>(vars);
+            declaredClauses = count;
+            formula.reserve(static_cast<size_t>(count));
+        } else {
+            long long lit;
+            if (!reader.readInt(lit)) {
+                cerr << "DIMACS line " << reader.line << ": unexpected character '" << c << "'" << endl;
+                return false;
+            }
+            if (numVars < 0) {
+                cerr << "DIMACS line " << reader.line << ": clause before the \"p cnf\" header" << endl;
+                return false;
+            }
+            if (lit == 0) {
+                formula.push_back(clause);
+                clause.clear();
+            } else if (lit > numVars || -lit > numVars) {
+                cerr << "DIMACS line " << reader.line << ": literal " << lit << " exceeds the " << numVars
+                     << " declared variables" << endl;
+                return false;
+            } else {
+                clause.push_back(static_cast<Literal>(lit));
+            }
+        }
+    }
+
+    if (numVars < 0) {
+        cerr << "DIMACS: missing \"p cnf\" header" << endl;
+        return false;
+    }
+    if (!clause.empty()) {
+        formula.push_back(clause);  // last clause without its terminating 0
+    }
+    if (static_cast<long long>(formula.size()) != declaredClauses) {
+        cerr << "DIMACS: header declares " << declaredClauses << " clauses, found " << formula.size() << endl;
+    }
+    return true;
+}
+
+bool readDimacs(const string &filename, IntFormula &formula, int &numVars) {
+    InputFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    return parseDimacs(file.data(), file.size(), formula, numVars);
+}
+
+void writeDimacs(const IntFormula &formula, int numVars, ostream &out) {
+    out << "p cnf " << numVars << " " << formula.size() << "\n";
+    for (const IntClause &clause: formula) {
+        for (Literal lit: clause) {
+            out << lit << " ";
+        }
+        out << "0\n";
+    }
+}
+
+void writeDimacsModel(const Model &model, int numVars, ostream &out) {
+    if (model.empty()) {
+        out << "s UNSATISFIABLE\n";
+        return;
+    }
+    out << "s SATISFIABLE\n";
+    string line = "v";
+    for (int var = 1; var <= numVars; ++var) {
+        string lit = " " + to_string(model[var] == VAL_TRUE ? var : -var);
+        if (line.size() + lit.size() > 78) {
+            out << line << "\n";
+            line = "v";
+        }
+        line += lit;
+    }
+    out << line << " 0\n";
+}
@@ -0,0 +1,25 @@
+#ifndef AILAB2_DIMACS_H
+#define AILAB2_DIMACS_H
+
+#include <iostream>
+#include <string>
+#include "DPLL.h"
+
+// Standard DIMACS CNF: optional "c" comment lines, a "p cnf <vars> <clauses>"
+// header, then clauses as whitespace-separated nonzero literals ended by 0.
+// Clauses may span lines; a "%" line (as in SATLIB files) ends the formula.
+
+// Parses size bytes at data. Literals outside 1..numVars, a missing header and
+// stray characters are errors, reported on cerr with their line number.
+bool parseDimacs(const char *data, size_t size, IntFormula &formula, int &numVars);
+
+bool readDimacs(const string &filename, IntFormula &formula, int &numVars);
+
+void writeDimacs(const IntFormula &formula, int numVars, ostream &out);
+
+// Competition output: "s SATISFIABLE" plus "v" lines listing every variable and
+// a final 0, or "s UNSATISFIABLE" for an empty model. Unassigned variables are
+// printed as false.
+void writeDimacsModel(const Model &model, int numVars, ostream &out);
+
+#endif //AILAB2_DIMACS_H
@@ -0,0 +1,112 @@
+#include "InputFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const size_t READ_CHUNK = 1 << 20;
+}
+
+InputFile::InputFile() : fd(-1), bytes(nullptr), length(0), mapped(false) {
+}
+
+InputFile::~InputFile() {
+    close();
+}
+
+void InputFile::close() {
+    if (mapped) {
+        munmap(const_cast<char *>(bytes), length);
+    }
+    if (fd > STDIN_FILENO) {
+        ::close(fd);
+    }
+    fd = -1;
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool InputFile::open(const string &path) {
+    close();
+    fd = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error opening file: " << path << endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *map = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            bytes = static_cast<const char *>(map);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+            return true;
+        }
+    }
+    if (!readAll()) {
+        cerr << "Error reading file: " << path << ": " << strerror(errno) << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Fallback for pipes and anything mmap() refuses.
+bool InputFile::readAll() {
+    size_t used = 0;
+    while (true) {
+        if (buffer.size() - used < READ_CHUNK) {
+            buffer.resize(used + READ_CHUNK);
+        }
+        ssize_t count = read(fd, buffer.data() + used, READ_CHUNK);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+        used += static_cast<size_t>(count);
+    }
+    // Only trim the size: shrink_to_fit() would copy the whole input again.
+    buffer.resize(used);
+    bytes = buffer.data();
+    length = used;
+    return true;
+}
+
+const char *InputFile::data() const {
+    return bytes;
+}
+
+size_t InputFile::size() const {
+    return length;
+}
+
+LineCursor::LineCursor(const char *data, size_t size) : pos(data), end(data + size) {
+}
+
+bool LineCursor::next(LineView &line) {
+    if (pos == end) {
+        return false;
+    }
+    const char *newline = static_cast<const char *>(memchr(pos, '\n', static_cast<size_t>(end - pos)));
+    const char *lineEnd = newline ? newline : end;
+    line.data = pos;
+    line.size = static_cast<size_t>(lineEnd - pos);
+    if (line.size > 0 && lineEnd[-1] == '\r') {
+        line.size--;
+    }
+    pos = newline ? newline + 1 : end;
+    return true;
+}
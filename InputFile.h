@@ -0,0 +1,54 @@
+#ifndef AILAB2_INPUTFILE_H
+#define AILAB2_INPUTFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Read-only view of a whole input file. Regular files are mmap()ed, so parsing
+// works straight on the page cache without a copy; pipes, other non-regular
+// files and "-" (stdin) are read with read() in large chunks instead.
+class InputFile {
+private:
+    int fd;
+    const char *bytes;
+    size_t length;
+    bool mapped;
+    vector<char> buffer;  // contents when not mapped
+
+    bool readAll();
+    void close();
+
+public:
+    InputFile();
+    ~InputFile();
+    InputFile(const InputFile &) = delete;
+    InputFile &operator=(const InputFile &) = delete;
+
+    // Reports failures on cerr.
+    bool open(const string &path);
+    const char *data() const;
+    size_t size() const;
+};
+
+// A line inside an InputFile, without its '\n' or "\r\n".
+struct LineView {
+    const char *data;
+    size_t size;
+};
+
+// Walks the lines of a buffer without copying them. A last line without a
+// trailing newline is still returned.
+class LineCursor {
+private:
+    const char *pos;
+    const char *end;
+
+public:
+    LineCursor(const char *data, size_t size);
+    bool next(LineView &line);
+};
+
+#endif //AILAB2_INPUTFILE_H
@@ -0,0 +1,79 @@
+#include "Portfolio.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ClauseExchange.h"
+#include "Solver.h"
+
+vector<SolverOptions> portfolioConfigs(const SolverOptions &base, int count) {
+    const RestartPolicy restarts[] = {RESTART_LUBY, RESTART_GLUCOSE, RESTART_LUBY, RESTART_GLUCOSE};
+    const InitialPhase phases[] = {PHASE_FALSE, PHASE_TRUE, PHASE_RANDOM};
+
+    vector<SolverOptions> configs;
+    for (int i = 0; i < count; ++i) {
+        SolverOptions config = base;
+        if (i > 0) {
+            config.mode = MODE_CDCL;
+            config.heuristic = i % 5 == 4 ? HEURISTIC_FIRST : HEURISTIC_VSIDS;
+            config.restart = restarts[i % 4];
+            config.lubyUnit = i % 4 == 2 ? 512 : 100;
+            config.phase = phases[i % 3];
+            config.varDecay = i % 2 ? 0.95 : 0.85;
+            config.seed = static_cast<unsigned>(i);
+        }
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+Model solvePortfolio(const IntFormula &formula, int numVars, const vector<SolverOptions> &configs,
+                     bool shareClauses, int *winner, SolverStats *stats) {
+    atomic<bool> stop(false);
+    ClauseExchange exchange;
+    mutex resultLock;
+    int first = -1;
+    Model result;
+
+    auto run = [&](int index) {
+        Solver solver(numVars, configs[index]);
+        solver.setCancelFlag(&stop);
+        if (shareClauses && configs[index].mode == MODE_CDCL) {
+            solver.setClauseExchange(&exchange, index);
+        }
+        for (const IntClause &clause: formula) {
+            if (!solver.addClause(clause)) {
+                break;
+            }
+        }
+        bool satisfiable = solver.solve();
+        if (solver.interrupted()) {
+            return;
+        }
+
+        lock_guard<mutex> guard(resultLock);
+        if (first < 0) {
+            first = index;
+            result = satisfiable ? solver.model() : Model();
+            if (stats) {
+                *stats = solver.stats();
+            }
+            stop.store(true, memory_order_relaxed);
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 1; i < static_cast<int>(configs.size()); ++i) {
+        threads.emplace_back(run, i);
+    }
+    if (!configs.empty()) {
+        run(0);
+    }
+    for (thread &t: threads) {
+        t.join();
+    }
+
+    if (winner) {
+        *winner = first;
+    }
+    return result;
+}
@@ -0,0 +1,21 @@
+#ifndef AILAB2_PORTFOLIO_H
+#define AILAB2_PORTFOLIO_H
+
+#include "DPLL.h"
+
+// Portfolio solving: one Solver per configuration on its own thread, all on the
+// same formula. The first to finish decides the answer and cancels the others.
+
+// count configurations derived from base. The first is base itself; the others
+// run MODE_CDCL and vary branching heuristic, restart policy, initial phase and
+// seed so that they explore the search space differently.
+vector<SolverOptions> portfolioConfigs(const SolverOptions &base, int count);
+
+// Returns the winning solver's model (empty for UNSAT). With shareClauses the
+// CDCL solvers pass short learned clauses to each other through a
+// ClauseExchange. winner receives the index of the configuration that finished
+// first and stats its counters.
+Model solvePortfolio(const IntFormula &formula, int numVars, const vector<SolverOptions> &configs,
+                     bool shareClauses, int *winner = nullptr, SolverStats *stats = nullptr);
+
+#endif //AILAB2_PORTFOLIO_H
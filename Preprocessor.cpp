@@ -0,0 +1,525 @@
+#include "Preprocessor.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const int MAX_ROUNDS = 3;
+    // Bounded variable elimination gives up on variables with more candidate
+    // resolvents than this, and never adds a resolvent longer than MAX_RESOLVENT.
+    const size_t RESOLUTION_BUDGET = 1024;
+    const size_t MAX_RESOLVENT = 24;
+
+    bool literalOrder(Literal a, Literal b) {
+        return abs(a) != abs(b) ? abs(a) < abs(b) : a < b;
+    }
+}
+
+void printPreprocessStats(const PreprocessStats &stats, ostream &out) {
+    out << "preprocess: removed " << stats.clausesBefore - stats.clausesAfter << " of " << stats.clausesBefore
+        << " clauses, " << stats.fixedVariables + stats.substitutedVariables + stats.eliminatedVariables
+        << " variables" << endl;
+    out << "  fixed: " << stats.fixedVariables << ", substituted: " << stats.substitutedVariables
+        << ", eliminated: " << stats.eliminatedVariables << endl;
+    out << "  subsumed clauses: " << stats.subsumedClauses << ", strengthened clauses: "
+        << stats.strengthenedClauses << endl;
+}
+
+Preprocessor::Preprocessor(int numVars)
+        : numVars(numVars), unsat(false), occurs(2 * (numVars + 1)), values(numVars + 1, VAL_UNASSIGNED),
+          removedVars(numVars + 1, 0), touched(numVars + 1, 1), unitHead(0), marks(2 * (numVars + 1), 0) {}
+
+int Preprocessor::literalIndex(Literal literal) {
+    return literal > 0 ? 2 * literal : -2 * literal + 1;
+}
+
+uint64_t Preprocessor::signature(const IntClause &clause) {
+    uint64_t bits = 0;
+    for (Literal literal: clause) {
+        bits |= 1ULL << (abs(literal) & 63);
+    }
+    return bits;
+}
+
+// Sorts by variable and drops repeated literals. Returns false for a tautology.
+bool Preprocessor::normalize(IntClause &clause) {
+    sort(clause.begin(), clause.end(), literalOrder);
+    clause.erase(unique(clause.begin(), clause.end()), clause.end());
+    for (size_t i = 1; i < clause.size(); ++i) {
+        if (clause[i] == -clause[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Merges two normalized clauses on var. Returns false if the resolvent is a tautology.
+bool Preprocessor::resolve(const IntClause &positive, const IntClause &negative, int var, IntClause &resolvent) {
+    resolvent.clear();
+    size_t i = 0, j = 0;
+    while (i < positive.size() || j < negative.size()) {
+        if (i < positive.size() && abs(positive[i]) == var) {
+            ++i;
+        } else if (j < negative.size() && abs(negative[j]) == var) {
+            ++j;
+        } else if (j == negative.size() || (i < positive.size() && abs(positive[i]) < abs(negative[j]))) {
+            resolvent.push_back(positive[i++]);
+        } else if (i == positive.size() || abs(negative[j]) < abs(positive[i])) {
+            resolvent.push_back(negative[j++]);
+        } else if (positive[i] == negative[j]) {
+            resolvent.push_back(positive[i++]);
+            ++j;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Preprocessor::touch(const IntClause &clause) {
+    for (Literal literal: clause) {
+        touched[abs(literal)] = 1;
+    }
+}
+
+// clause must be normalized. Fixed literals are applied first; what is left
+// becomes a unit, the empty clause or a stored clause.
+void Preprocessor::addClause(IntClause clause) {
+    size_t kept = 0;
+    for (Literal literal: clause) {
+        int8_t value = values[abs(literal)];
+        if (value == VAL_UNASSIGNED) {
+            clause[kept++] = literal;
+        } else if ((value == VAL_TRUE) == (literal > 0)) {
+            return;
+        }
+    }
+    clause.resize(kept);
+    if (clause.empty()) {
+        unsat = true;
+        return;
+    }
+    if (clause.size() == 1) {
+        assign(clause[0]);
+        return;
+    }
+
+    int index = static_cast<int>(clauses.size());
+    for (Literal literal: clause) {
+        occurs[literalIndex(literal)].push_back(index);
+    }
+    touch(clause);
+    signatures.push_back(signature(clause));
+    clauses.push_back(std::move(clause));
+    removed.push_back(0);
+    queued.push_back(1);
+    subsumeQueue.push_back(index);
+}
+
+void Preprocessor::removeClause(int index) {
+    removed[index] = 1;
+    touch(clauses[index]);
+    IntClause().swap(clauses[index]);
+}
+
+// Removes literal from a stored clause, which may leave a unit.
+void Preprocessor::strengthen(int index, Literal literal) {
+    IntClause &clause = clauses[index];
+    touch(clause);  // before the erase: literal's variable loses an occurrence too
+    clause.erase(find(clause.begin(), clause.end(), literal));
+    vector<int> &list = occurs[literalIndex(literal)];
+    list.erase(find(list.begin(), list.end(), index));
+
+    if (clause.size() == 1) {
+        Literal unit = clause[0];
+        removeClause(index);
+        assign(unit);
+        return;
+    }
+    signatures[index] = signature(clause);
+    if (!queued[index]) {
+        queued[index] = 1;
+        subsumeQueue.push_back(index);
+    }
+}
+
+void Preprocessor::assign(Literal literal) {
+    int8_t value = values[abs(literal)];
+    if (value != VAL_UNASSIGNED) {
+        if ((value == VAL_TRUE) != (literal > 0)) {
+            unsat = true;
+        }
+        return;
+    }
+    values[abs(literal)] = literal > 0 ? VAL_TRUE : VAL_FALSE;
+    removedVars[abs(literal)] = 1;
+    units.push_back(literal);
+    stack.push_back(Reconstruction{{literal}, literal});
+    ++statistics.fixedVariables;
+}
+
+vector<int> &Preprocessor::liveOccurrences(Literal literal) {
+    vector<int> &list = occurs[literalIndex(literal)];
+    list.erase(remove_if(list.begin(), list.end(), [this](int index) { return removed[index] != 0; }), list.end());
+    return list;
+}
+
+void Preprocessor::propagateUnits() {
+    while (unitHead < units.size() && !unsat) {
+        Literal literal = units[unitHead++];
+        for (int index: liveOccurrences(literal)) {
+            removeClause(index);
+        }
+        occurs[literalIndex(literal)].clear();
+        vector<int> falsified = liveOccurrences(-literal);
+        for (int index: falsified) {
+            if (!removed[index]) {
+                strengthen(index, -literal);
+            }
+        }
+    }
+}
+
+// Tarjan's algorithm (iterative) on the implication graph of the binary
+// clauses: a v b gives !a -> b and !b -> a. Every literal of a component is
+// replaced by its literal with the smallest variable; the dual component picks
+// the negation of the same literal, so the choice is consistent.
+bool Preprocessor::substituteEquivalences() {
+    int nodes = 2 * (numVars + 1);
+    vector<int> start(nodes + 1, 0);
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (!removed[i] && clauses[i].size() == 2) {
+            ++start[literalIndex(-clauses[i][0]) + 1];
+            ++start[literalIndex(-clauses[i][1]) + 1];
+        }
+    }
+    for (int node = 0; node < nodes; ++node) {
+        start[node + 1] += start[node];
+    }
+    if (start[nodes] == 0) {
+        return false;
+    }
+    vector<Literal> targets(start[nodes]);
+    vector<int> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (!removed[i] && clauses[i].size() == 2) {
+            Literal a = clauses[i][0], b = clauses[i][1];
+            targets[fill[literalIndex(-a)]++] = b;
+            targets[fill[literalIndex(-b)]++] = a;
+        }
+    }
+
+    const int UNVISITED = -1;
+    vector<int> order(nodes, UNVISITED), low(nodes, 0);
+    vector<char> onStack(nodes, 0);
+    vector<Literal> componentStack;
+    vector<pair<Literal, int>> callStack;  // literal and the next edge to follow
+    vector<Literal> representative(nodes, 0);
+    int counter = 0;
+    for (int var = 1; var <= numVars && !unsat; ++var) {
+        for (Literal root: {var, -var}) {
+            if (order[literalIndex(root)] != UNVISITED || removedVars[var]) {
+                continue;
+            }
+            callStack.push_back({root, start[literalIndex(root)]});
+            order[literalIndex(root)] = low[literalIndex(root)] = counter++;
+            componentStack.push_back(root);
+            onStack[literalIndex(root)] = 1;
+            while (!callStack.empty()) {
+                Literal literal = callStack.back().first;
+                int node = literalIndex(literal);
+                int &edge = callStack.back().second;
+                if (edge < start[node + 1]) {
+                    Literal next = targets[edge++];
+                    int nextNode = literalIndex(next);
+                    if (order[nextNode] == UNVISITED) {
+                        order[nextNode] = low[nextNode] = counter++;
+                        componentStack.push_back(next);
+                        onStack[nextNode] = 1;
+                        callStack.push_back({next, start[nextNode]});
+                    } else if (onStack[nextNode]) {
+                        low[node] = min(low[node], order[nextNode]);
+                    }
+                    continue;
+                }
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    int parent = literalIndex(callStack.back().first);
+                    low[parent] = min(low[parent], low[node]);
+                }
+                if (low[node] != order[node]) {
+                    continue;
+                }
+                // node is the root of a component: pop it.
+                auto first = find(componentStack.begin(), componentStack.end(), literal);
+                Literal best = literal;
+                for (auto it = first; it != componentStack.end(); ++it) {
+                    if (abs(*it) < abs(best)) {
+                        best = *it;
+                    }
+                }
+                for (auto it = first; it != componentStack.end(); ++it) {
+                    onStack[literalIndex(*it)] = 0;
+                    representative[literalIndex(*it)] = best;
+                }
+                for (auto it = first; it != componentStack.end(); ++it) {
+                    if (representative[literalIndex(-*it)] == best) {
+                        unsat = true;  // l and !l in one component
+                    }
+                }
+                componentStack.erase(first, componentStack.end());
+            }
+        }
+    }
+    if (unsat) {
+        return true;
+    }
+
+    bool substituted = false;
+    for (int var = 1; var <= numVars; ++var) {
+        Literal equal = representative[literalIndex(var)];
+        if (removedVars[var] || equal == 0 || equal == var) {
+            continue;
+        }
+        removedVars[var] = 1;
+        stack.push_back(Reconstruction{{var, -equal}, var});
+        stack.push_back(Reconstruction{{-var, equal}, -var});
+        ++statistics.substitutedVariables;
+        substituted = true;
+    }
+    if (!substituted) {
+        return false;
+    }
+
+    // Rewrite every clause and rebuild the occurrence lists from scratch.
+    vector<IntClause> old;
+    old.swap(clauses);
+    vector<char> oldRemoved;
+    oldRemoved.swap(removed);
+    signatures.clear();
+    queued.clear();
+    subsumeQueue.clear();
+    for (vector<int> &list: occurs) {
+        list.clear();
+    }
+    for (size_t i = 0; i < old.size() && !unsat; ++i) {
+        if (oldRemoved[i]) {
+            continue;
+        }
+        IntClause clause;
+        clause.swap(old[i]);
+        for (Literal &literal: clause) {
+            Literal equal = representative[literalIndex(literal)];
+            if (equal != 0) {
+                literal = equal;
+            }
+        }
+        if (normalize(clause)) {
+            addClause(std::move(clause));
+        }
+    }
+    return true;
+}
+
+void Preprocessor::backwardSubsume() {
+    propagateUnits();
+    IntClause clause;
+    vector<int> candidates;
+    while (!subsumeQueue.empty() && !unsat) {
+        int index = subsumeQueue.back();
+        subsumeQueue.pop_back();
+        queued[index] = 0;
+        if (removed[index]) {
+            continue;
+        }
+        clause = clauses[index];
+
+        // Any clause it subsumes or strengthens has best or !best.
+        Literal best = clause[0];
+        size_t bestCount = SIZE_MAX;
+        for (Literal literal: clause) {
+            size_t count = occurs[literalIndex(literal)].size() + occurs[literalIndex(-literal)].size();
+            if (count < bestCount) {
+                best = literal;
+                bestCount = count;
+            }
+        }
+        candidates = liveOccurrences(best);
+        const vector<int> &negated = liveOccurrences(-best);
+        candidates.insert(candidates.end(), negated.begin(), negated.end());
+
+        for (Literal literal: clause) {
+            marks[literalIndex(literal)] = 1;
+        }
+        for (int other: candidates) {
+            if (other == index || removed[other] || removed[index] || clauses[other].size() < clause.size() ||
+                (signatures[index] & ~signatures[other]) != 0) {
+                continue;
+            }
+            size_t matched = 0, flips = 0;
+            Literal flipped = 0;
+            for (Literal literal: clauses[other]) {
+                if (marks[literalIndex(literal)]) {
+                    ++matched;
+                } else if (marks[literalIndex(-literal)]) {
+                    ++flips;
+                    flipped = literal;
+                }
+            }
+            if (matched == clause.size()) {
+                removeClause(other);
+                ++statistics.subsumedClauses;
+            } else if (flips == 1 && matched + 1 == clause.size()) {
+                strengthen(other, flipped);
+                ++statistics.strengthenedClauses;
+            }
+        }
+        for (Literal literal: clause) {
+            marks[literalIndex(literal)] = 0;
+        }
+        propagateUnits();
+    }
+}
+
+bool Preprocessor::eliminateVariable(int var) {
+    if (removedVars[var] || !touched[var]) {
+        return false;
+    }
+    touched[var] = 0;
+    vector<int> positive = liveOccurrences(var);
+    vector<int> negative = liveOccurrences(-var);
+    if (positive.empty() && negative.empty()) {
+        return false;
+    }
+    if (positive.size() * negative.size() > RESOLUTION_BUDGET) {
+        return false;
+    }
+
+    vector<IntClause> resolvents;
+    IntClause resolvent;
+    size_t limit = positive.size() + negative.size();
+    for (int p: positive) {
+        for (int n: negative) {
+            if (!resolve(clauses[p], clauses[n], var, resolvent)) {
+                continue;
+            }
+            if (resolvent.size() > MAX_RESOLVENT || resolvents.size() == limit) {
+                return false;
+            }
+            resolvents.push_back(resolvent);
+        }
+    }
+
+    // Keep the smaller side: with x = false by default, x is set only where one
+    // of its clauses would otherwise be falsified.
+    bool keepPositive = positive.size() <= negative.size();
+    Literal witness = keepPositive ? var : -var;
+    for (int index: keepPositive ? positive : negative) {
+        stack.push_back(Reconstruction{clauses[index], witness});
+    }
+    stack.push_back(Reconstruction{{-witness}, -witness});
+    for (int index: positive) {
+        removeClause(index);
+    }
+    for (int index: negative) {
+        removeClause(index);
+    }
+    occurs[literalIndex(var)].clear();
+    occurs[literalIndex(-var)].clear();
+    removedVars[var] = 1;
+    ++statistics.eliminatedVariables;
+
+    for (IntClause &clause: resolvents) {
+        addClause(std::move(clause));
+    }
+    return true;
+}
+
+// Tries every variable touched since its last attempt, fewest occurrences first.
+bool Preprocessor::eliminateVariables() {
+    vector<pair<size_t, int>> candidates;
+    for (int var = 1; var <= numVars; ++var) {
+        if (!removedVars[var] && touched[var]) {
+            candidates.push_back({liveOccurrences(var).size() + liveOccurrences(-var).size(), var});
+        }
+    }
+    sort(candidates.begin(), candidates.end());
+
+    bool eliminated = false;
+    for (const auto &candidate: candidates) {
+        if (unsat) {
+            break;
+        }
+        if (eliminateVariable(candidate.second)) {
+            eliminated = true;
+            backwardSubsume();
+        }
+    }
+    return eliminated;
+}
+
+bool Preprocessor::simplify(IntFormula &formula) {
+    statistics.clausesBefore = static_cast<long long>(formula.size());
+    for (IntClause &clause: formula) {
+        if (unsat) {
+            break;
+        }
+        IntClause copy;
+        copy.swap(clause);
+        if (normalize(copy)) {
+            addClause(std::move(copy));
+        }
+    }
+    IntFormula().swap(formula);
+
+    for (int round = 0; round < MAX_ROUNDS && !unsat; ++round) {
+        propagateUnits();
+        bool changed = substituteEquivalences();
+        backwardSubsume();
+        changed = eliminateVariables() || changed;
+        if (!changed) {
+            break;
+        }
+    }
+
+    if (unsat) {
+        formula.push_back(IntClause());
+        statistics.clausesAfter = 1;
+        return false;
+    }
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (!removed[i]) {
+            formula.push_back(std::move(clauses[i]));
+        }
+    }
+    statistics.clausesAfter = static_cast<long long>(formula.size());
+    return true;
+}
+
+void Preprocessor::extendModel(Model &model) const {
+    if (model.empty()) {
+        return;
+    }
+    // The stack assumes a full assignment; variables left unassigned by the
+    // solver (those it never saw in a clause) are false.
+    for (size_t var = 1; var < model.size(); ++var) {
+        if (model[var] == VAL_UNASSIGNED) {
+            model[var] = VAL_FALSE;
+        }
+    }
+    for (auto entry = stack.rbegin(); entry != stack.rend(); ++entry) {
+        bool satisfied = false;
+        for (Literal literal: entry->clause) {
+            if (model[abs(literal)] == (literal > 0 ? VAL_TRUE : VAL_FALSE)) {
+                satisfied = true;
+                break;
+            }
+        }
+        if (!satisfied) {
+            model[abs(entry->witness)] = entry->witness > 0 ? VAL_TRUE : VAL_FALSE;
+        }
+    }
+}
+
+const PreprocessStats &Preprocessor::stats() const {
+    return statistics;
+}
@@ -0,0 +1,91 @@
+#ifndef AILAB2_PREPROCESSOR_H
+#define AILAB2_PREPROCESSOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "DPLL.h"
+
+using namespace std;
+
+struct PreprocessStats {
+    long long clausesBefore = 0;
+    long long clausesAfter = 0;
+    int fixedVariables = 0;        // assigned by top-level unit propagation
+    int substitutedVariables = 0;  // replaced by an equivalent literal
+    int eliminatedVariables = 0;   // resolved away
+    long long subsumedClauses = 0;
+    long long strengthenedClauses = 0;  // lost a literal to self-subsuming resolution
+};
+
+void printPreprocessStats(const PreprocessStats &stats, ostream &out);
+
+// SatELite-style simplification of a formula before the search:
+// - top-level unit propagation;
+// - equivalent literal substitution: the literals of a strongly connected
+//   component of the binary implication graph are replaced by one of them;
+// - backward subsumption and self-subsuming resolution over occurrence lists,
+//   with 64-bit variable signatures to skip most candidate pairs;
+// - bounded variable elimination: x goes if its non-tautological resolvents
+//   are no more than the clauses containing x.
+//
+// Variable ids are kept; removed variables just no longer occur. Every removal
+// is pushed on a reconstruction stack of (clause, witness) pairs, and
+// extendModel() walks it backwards, making the witness true wherever its clause
+// is not satisfied, to turn a model of the simplified formula into a model of
+// the original one.
+class Preprocessor {
+private:
+    struct Reconstruction {
+        IntClause clause;
+        Literal witness;
+    };
+
+    int numVars;
+    bool unsat;
+    vector<IntClause> clauses;  // kept sorted by variable, see normalize()
+    vector<char> removed;
+    vector<uint64_t> signatures;
+    vector<vector<int>> occurs;  // occurs[literalIndex(l)]: clauses with l, may list removed ones
+    vector<int8_t> values;
+    vector<char> removedVars;  // fixed, substituted or eliminated
+    vector<char> touched;      // occurrences changed since the last elimination attempt
+    vector<Literal> units;     // fixed literals; propagated up to unitHead
+    size_t unitHead;
+    vector<int> subsumeQueue;
+    vector<char> queued;
+    vector<char> marks;  // by literal index
+    vector<Reconstruction> stack;
+    PreprocessStats statistics;
+
+    static int literalIndex(Literal literal);
+    static uint64_t signature(const IntClause &clause);
+    static bool normalize(IntClause &clause);
+    static bool resolve(const IntClause &positive, const IntClause &negative, int var, IntClause &resolvent);
+
+    void touch(const IntClause &clause);
+    void addClause(IntClause clause);
+    void removeClause(int index);
+    void strengthen(int index, Literal literal);
+    void assign(Literal literal);
+    vector<int> &liveOccurrences(Literal literal);
+
+    void propagateUnits();
+    bool substituteEquivalences();
+    void backwardSubsume();
+    bool eliminateVariable(int var);
+    bool eliminateVariables();
+
+public:
+    explicit Preprocessor(int numVars);
+
+    // Replaces formula with the simplified one. Returns false if it was found
+    // unsatisfiable (formula is then a single empty clause).
+    bool simplify(IntFormula &formula);
+    // Completes a model of the simplified formula, assigning every variable; an
+    // empty model (UNSAT) stays empty.
+    void extendModel(Model &model) const;
+    const PreprocessStats &stats() const;
+};
+
+#endif //AILAB2_PREPROCESSOR_H
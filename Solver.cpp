@@ -0,0 +1,1010 @@
+#include "Solver.h"
+#include <cstdlib>
+#include <cmath>
+#include <random>
+
+const int Solver::NO_CONFLICT;
+const int Solver::NO_REASON;
+
+Solver::Solver(int numVars, const SolverOptions &options)
+        : options(options), numVars(numVars), unsat(false), watches(2 * (numVars + 1)),
+          values(numVars + 1, VAL_UNASSIGNED), levels(numVars + 1, 0), reasons(numVars + 1, NO_REASON),
+          propagateHead(0), activity(numVars + 1, 0), order(activity, numVars), varIncrement(1),
+          savedPhases(numVars + 1, VAL_TRUE), conflictsSinceRestart(0), lubyIndex(0), lbdFast(0), lbdSlow(0),
+          seen(numVars + 1, 0), levelStamps(numVars + 2, 0), stamp(0), numLearnts(0), maxLearnts(0),
+          clauseIncrement(1), cancelFlag(nullptr), wasInterrupted(false), exchange(nullptr), exchangeId(0),
+          exchangeCursor(0), pureStart(0), coreAnalyzed(true), probedLevel(-1), probedTrail(0), probedDecisions(0) {
+    // A seed only perturbs ties: initial activities stay far below one bump.
+    mt19937 random(options.seed);
+    for (int var = 1; var <= numVars; ++var) {
+        if (options.seed) {
+            activity[var] = random() * 1e-12;
+        }
+        if (options.phase == PHASE_FALSE || (options.phase == PHASE_RANDOM && (random() & 1))) {
+            savedPhases[var] = VAL_FALSE;
+        }
+    }
+    trail.reserve(numVars);
+    trailLimits.reserve(numVars);
+    levelFlipped.reserve(numVars);
+}
+
+int Solver::watchIndex(Literal literal) const {
+    return literal > 0 ? 2 * literal : -2 * literal + 1;
+}
+
+int8_t Solver::valueOf(Literal literal) const {
+    int8_t value = values[abs(literal)];
+    return literal > 0 ? value : static_cast<int8_t>(-value);
+}
+
+void Solver::enqueue(Literal literal, int reason) {
+    int var = abs(literal);
+    values[var] = literal > 0 ? VAL_TRUE : VAL_FALSE;
+    levels[var] = decisionLevel();
+    reasons[var] = reason;
+    trail.push_back(literal);
+    if (reason != NO_REASON) {
+        statistics.propagations++;
+    }
+}
+
+void Solver::undoTo(size_t trailSize, bool savePhases) {
+    while (trail.size() > trailSize) {
+        int var = abs(trail.back());
+        if (options.phaseSaving && savePhases) {
+            savedPhases[var] = values[var];
+        }
+        values[var] = VAL_UNASSIGNED;
+        reasons[var] = NO_REASON;
+        order.insert(var);
+        trail.pop_back();
+    }
+    propagateHead = trailSize;
+}
+
+int Solver::decisionLevel() const {
+    return static_cast<int>(trailLimits.size());
+}
+
+void Solver::decide(Literal literal, bool flipped) {
+    trailLimits.push_back(trail.size());
+    levelFlipped.push_back(flipped);
+    enqueue(literal, NO_REASON);
+    statistics.decisions++;
+}
+
+void Solver::cancelUntil(int level, bool savePhases) {
+    if (decisionLevel() > level) {
+        undoTo(trailLimits[level], savePhases);
+        trailLimits.resize(level);
+        levelFlipped.resize(level);
+    }
+}
+
+int Solver::attachClause(const IntClause &lits, bool learnt) {
+    int index = static_cast<int>(clauses.size());
+    watches[watchIndex(lits[0])].push_back(index);
+    watches[watchIndex(lits[1])].push_back(index);
+    clauses.push_back(SolverClause{lits, learnt, false, 0, 0});
+    return index;
+}
+
+bool Solver::addClause(const IntClause &clause) {
+    return insertClause(clause, false);
+}
+
+// Adds an input clause, or a learned one received from another solver, at
+// level 0. Returns false once the formula is known to be unsatisfiable.
+bool Solver::insertClause(const IntClause &clause, bool learnt) {
+    if (unsat) {
+        return false;
+    }
+
+    // Only variables that occur in some clause are ever decided; the rest stay
+    // unassigned in the model.
+    for (Literal lit: clause) {
+        if (values[abs(lit)] == VAL_UNASSIGNED) {
+            order.insert(abs(lit));
+        }
+    }
+
+    // Drop duplicate literals and clauses that are tautologies or already satisfied.
+    IntClause lits;
+    for (Literal lit: clause) {
+        if (valueOf(lit) == VAL_TRUE || find(lits.begin(), lits.end(), -lit) != lits.end()) {
+            return true;
+        }
+        if (valueOf(lit) == VAL_UNASSIGNED && find(lits.begin(), lits.end(), lit) == lits.end()) {
+            lits.push_back(lit);
+        }
+    }
+
+    if (lits.empty()) {
+        unsat = true;
+        return false;
+    }
+    if (lits.size() == 1) {
+        enqueue(lits[0], NO_REASON);
+        if (propagate() != NO_CONFLICT) {
+            unsat = true;
+            return false;
+        }
+        return true;
+    }
+
+    int index = attachClause(lits, learnt);
+    if (learnt) {
+        clauses[index].lbd = static_cast<int>(lits.size());
+        numLearnts++;
+    }
+    return true;
+}
+
+// Returns the index of a falsified clause, or NO_CONFLICT. Only the clauses
+// watching a literal that just became false are visited.
+int Solver::propagate() {
+    while (propagateHead < trail.size()) {
+        Literal falseLit = -trail[propagateHead++];
+        vector<int> &watchList = watches[watchIndex(falseLit)];
+
+        size_t i = 0, j = 0;
+        while (i < watchList.size()) {
+            int index = watchList[i++];
+            IntClause &lits = clauses[index].lits;
+            if (lits[0] == falseLit) {
+                swap(lits[0], lits[1]);
+            }
+            if (valueOf(lits[0]) == VAL_TRUE) {
+                watchList[j++] = index;
+                continue;
+            }
+
+            // Look for a new literal to watch instead of falseLit.
+            bool moved = false;
+            for (size_t k = 2; k < lits.size(); ++k) {
+                if (valueOf(lits[k]) != VAL_FALSE) {
+                    swap(lits[1], lits[k]);
+                    watches[watchIndex(lits[1])].push_back(index);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+
+            watchList[j++] = index;
+            if (valueOf(lits[0]) == VAL_FALSE) {
+                while (i < watchList.size()) {
+                    watchList[j++] = watchList[i++];
+                }
+                watchList.resize(j);
+                return index;
+            }
+            enqueue(lits[0], index);
+        }
+        watchList.resize(j);
+    }
+    return NO_CONFLICT;
+}
+
+// Decides the next literal: pending assumptions first, each on its own level
+// (an empty one if it already holds), then the branching heuristic. Returns
+// false if an assumption is false, i.e. there is no model under them; next is
+// 0 when there is nothing left to decide. Pure literals follow the assumptions
+// but are not counted as decisions, and one that has become false is skipped.
+bool Solver::decideNext(Literal &next) {
+    while (decisionLevel() < static_cast<int>(assumptions.size())) {
+        bool pure = static_cast<size_t>(decisionLevel()) >= pureStart;
+        Literal assumption = assumptions[decisionLevel()];
+        int8_t value = valueOf(assumption);
+        if (value == VAL_FALSE && !pure) {
+            core.assign(1, assumption);
+            analyzeFinal(IntClause(1, assumption));
+            return false;
+        }
+        if (value == VAL_UNASSIGNED) {
+            if (pure) {
+                trailLimits.push_back(trail.size());
+                levelFlipped.push_back(true);
+                enqueue(assumption, NO_REASON);
+            } else {
+                decide(assumption, true);
+            }
+            next = assumption;
+            return true;
+        }
+        trailLimits.push_back(trail.size());
+        levelFlipped.push_back(true);
+    }
+    next = pickBranchLiteral();
+    if (next != 0) {
+        decide(next, false);
+    }
+    return true;
+}
+
+// Returns the next decision literal, or 0 when there is nothing left to decide.
+Literal Solver::pickBranchLiteral() {
+    switch (options.heuristic) {
+        case HEURISTIC_FIRST:
+            return pickFirstLiteral();
+        case HEURISTIC_MRV:
+            return pickMrvLiteral();
+        default:
+            return pickVsidsLiteral();
+    }
+}
+
+// Same rule the string dpll() used: branch on the first open literal of the
+// first clause that is not yet satisfied. Returns 0 when every clause is satisfied.
+// Learned clauses are implied by the others and are skipped.
+Literal Solver::pickFirstLiteral() const {
+    for (const SolverClause &clause: clauses) {
+        if (clause.learnt) {
+            continue;
+        }
+        Literal open = 0;
+        bool satisfied = false;
+        for (Literal lit: clause.lits) {
+            int8_t value = valueOf(lit);
+            if (value == VAL_TRUE) {
+                satisfied = true;
+                break;
+            }
+            if (value == VAL_UNASSIGNED && open == 0) {
+                open = lit;
+            }
+        }
+        if (!satisfied && open != 0) {
+            return abs(open);
+        }
+    }
+    return 0;
+}
+
+Literal Solver::pickVsidsLiteral() {
+    while (!order.empty()) {
+        int var = order.removeMax();
+        if (values[var] == VAL_UNASSIGNED) {
+            return savedPhases[var] == VAL_FALSE ? -var : var;
+        }
+    }
+    return 0;
+}
+
+// Minimum remaining values: among the groups that have no true variable yet,
+// take the one with the fewest open variables and try its first open variable.
+Literal Solver::pickMrvLiteral() {
+    int bestCount = 0;
+    Literal best = 0;
+    for (const IntClause &group: options.mrvGroups) {
+        int count = 0;
+        Literal firstOpen = 0;
+        bool decided = false;
+        for (int var: group) {
+            if (values[var] == VAL_TRUE) {
+                decided = true;
+                break;
+            }
+            if (values[var] == VAL_UNASSIGNED) {
+                if (count++ == 0) {
+                    firstOpen = var;
+                }
+            }
+        }
+        if (!decided && count > 0 && (best == 0 || count < bestCount)) {
+            best = firstOpen;
+            bestCount = count;
+            if (count == 1) {
+                break;
+            }
+        }
+    }
+    return best != 0 ? best : pickVsidsLiteral();
+}
+
+void Solver::bumpVar(int var) {
+    activity[var] += varIncrement;
+    if (activity[var] > 1e100) {
+        for (double &a: activity) {
+            a *= 1e-100;
+        }
+        varIncrement *= 1e-100;
+    }
+    order.increased(var);
+}
+
+void Solver::decayVarActivity() {
+    varIncrement /= options.varDecay;
+}
+
+// Chronological backtracking: drop every level whose decision has been tried
+// both ways (assumption levels count as tried), then flip the most recent one.
+// Returns false when none is left.
+bool Solver::backtrack() {
+    while (decisionLevel() > 0) {
+        bool flipped = levelFlipped.back();
+        Literal decision = flipped ? 0 : trail[trailLimits.back()];
+
+        cancelUntil(decisionLevel() - 1);
+
+        if (!flipped) {
+            decide(-decision, true);
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned Solver::abstractLevel(int var) const {
+    return 1u << (levels[var] & 31);
+}
+
+// Adds to core the assumptions the negations of start follow from, walking the
+// trail back through reason clauses. A literal without a reason above level 0
+// is an assumption, a pure literal (which never rules a model out, so it is
+// left out) or one forced by probing under MODE_DPLL, which stands for every
+// assumption below it.
+void Solver::analyzeFinal(const IntClause &start) {
+    if (trailLimits.empty()) {
+        return;
+    }
+    for (Literal lit: start) {
+        if (levels[abs(lit)] > 0) {
+            seen[abs(lit)] = 1;
+        }
+    }
+    size_t probedBelow = 0;
+    for (size_t i = trail.size(); i-- > trailLimits[0];) {
+        int var = abs(trail[i]);
+        if (!seen[var]) {
+            continue;
+        }
+        seen[var] = 0;
+        size_t level = static_cast<size_t>(levels[var]);
+        if (reasons[var] != NO_REASON) {
+            const IntClause &lits = clauses[reasons[var]].lits;
+            for (size_t j = 1; j < lits.size(); ++j) {
+                if (levels[abs(lits[j])] > 0) {
+                    seen[abs(lits[j])] = 1;
+                }
+            }
+        } else if (level > assumptions.size() || trail[i] != assumptions[level - 1]) {
+            probedBelow = max(probedBelow, min(level, pureStart));
+        } else if (level <= pureStart) {
+            core.push_back(trail[i]);
+        }
+    }
+    for (size_t i = 0; i < probedBelow; ++i) {
+        if (find(core.begin(), core.end(), assumptions[i]) == core.end()) {
+            core.push_back(assumptions[i]);
+        }
+    }
+}
+
+// First-UIP analysis. learnt[0] is the asserting literal and learnt[1] (if any)
+// has the highest level among the rest, which is where the search jumps back to.
+void Solver::analyze(int conflict, IntClause &learnt, int &backtrackLevel) {
+    learnt.clear();
+    learnt.push_back(0);
+
+    int pathCount = 0;
+    Literal implied = 0;
+    int index = static_cast<int>(trail.size()) - 1;
+    int reason = conflict;
+
+    do {
+        SolverClause &clause = clauses[reason];
+        if (clause.learnt) {
+            bumpClause(clause);
+        }
+        for (size_t j = implied == 0 ? 0 : 1; j < clause.lits.size(); ++j) {
+            Literal lit = clause.lits[j];
+            int var = abs(lit);
+            if (!seen[var] && levels[var] > 0) {
+                seen[var] = 1;
+                bumpVar(var);
+                if (levels[var] >= decisionLevel()) {
+                    pathCount++;
+                } else {
+                    learnt.push_back(lit);
+                }
+            }
+        }
+
+        while (!seen[abs(trail[index])]) {
+            index--;
+        }
+        implied = trail[index--];
+        reason = reasons[abs(implied)];
+        seen[abs(implied)] = 0;
+        pathCount--;
+    } while (pathCount > 0);
+    learnt[0] = -implied;
+
+    // Recursive minimization: drop literals implied by the rest of the clause.
+    vector<int> toClear;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        toClear.push_back(abs(learnt[i]));
+    }
+    unsigned abstractLevels = 0;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        abstractLevels |= abstractLevel(abs(learnt[i]));
+    }
+    size_t kept = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        int var = abs(learnt[i]);
+        if (reasons[var] == NO_REASON || !literalRedundant(learnt[i], abstractLevels, toClear)) {
+            learnt[kept++] = learnt[i];
+        }
+    }
+    learnt.resize(kept);
+
+    backtrackLevel = 0;
+    if (learnt.size() > 1) {
+        size_t maxIndex = 1;
+        for (size_t i = 2; i < learnt.size(); ++i) {
+            if (levels[abs(learnt[i])] > levels[abs(learnt[maxIndex])]) {
+                maxIndex = i;
+            }
+        }
+        swap(learnt[1], learnt[maxIndex]);
+        backtrackLevel = levels[abs(learnt[1])];
+    }
+
+    for (int var: toClear) {
+        seen[var] = 0;
+    }
+}
+
+// True if literal is implied by literals already in the learned clause (marked
+// in seen). Literals proven redundant stay marked so later checks reuse them;
+// they are added to toClear.
+bool Solver::literalRedundant(Literal literal, unsigned abstractLevels, vector<int> &toClear) {
+    vector<Literal> stack(1, literal);
+    vector<int> marked;
+    while (!stack.empty()) {
+        const IntClause &lits = clauses[reasons[abs(stack.back())]].lits;
+        stack.pop_back();
+        for (size_t i = 1; i < lits.size(); ++i) {
+            int var = abs(lits[i]);
+            if (seen[var] || levels[var] == 0) {
+                continue;
+            }
+            if (reasons[var] == NO_REASON || (abstractLevel(var) & abstractLevels) == 0) {
+                for (int m: marked) {
+                    seen[m] = 0;
+                }
+                return false;
+            }
+            seen[var] = 1;
+            marked.push_back(var);
+            stack.push_back(lits[i]);
+        }
+    }
+    toClear.insert(toClear.end(), marked.begin(), marked.end());
+    return true;
+}
+
+// Literal block distance: the number of distinct decision levels in the clause.
+int Solver::computeLbd(const IntClause &lits) {
+    // Assumption and pure literal levels can outnumber the variables: an
+    // assumption that already holds gets an empty level.
+    if (levelStamps.size() <= static_cast<size_t>(decisionLevel())) {
+        levelStamps.resize(decisionLevel() + 1, 0);
+    }
+    stamp++;
+    int lbd = 0;
+    for (Literal lit: lits) {
+        int level = levels[abs(lit)];
+        if (levelStamps[level] != stamp) {
+            levelStamps[level] = stamp;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
+void Solver::bumpClause(SolverClause &clause) {
+    clause.activity += clauseIncrement;
+    if (clause.activity > 1e20) {
+        for (SolverClause &c: clauses) {
+            if (c.learnt) {
+                c.activity *= 1e-20;
+            }
+        }
+        clauseIncrement *= 1e-20;
+    }
+}
+
+bool Solver::locked(int index) const {
+    Literal first = clauses[index].lits[0];
+    return reasons[abs(first)] == index && valueOf(first) == VAL_TRUE;
+}
+
+// Delete the worse half of the learned clauses: highest LBD first, lowest
+// activity to break ties. Glue clauses (LBD <= 2) and current reasons are kept.
+void Solver::reduceLearnts() {
+    vector<int> candidates;
+    for (int i = 0; i < static_cast<int>(clauses.size()); ++i) {
+        if (clauses[i].learnt && clauses[i].lbd > 2 && !locked(i)) {
+            candidates.push_back(i);
+        }
+    }
+    sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+        if (clauses[a].lbd != clauses[b].lbd) {
+            return clauses[a].lbd > clauses[b].lbd;
+        }
+        return clauses[a].activity < clauses[b].activity;
+    });
+    for (size_t i = 0; i < candidates.size() / 2; ++i) {
+        clauses[candidates[i]].deleted = true;
+        numLearnts--;
+        statistics.deletedClauses++;
+    }
+    removeDeletedClauses();
+}
+
+// Compacts the clause vector and rewrites watch lists and reasons to the new indices.
+void Solver::removeDeletedClauses() {
+    vector<int> newIndex(clauses.size(), NO_REASON);
+    size_t kept = 0;
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (!clauses[i].deleted) {
+            newIndex[i] = static_cast<int>(kept);
+            if (kept != i) {
+                clauses[kept] = move(clauses[i]);
+            }
+            kept++;
+        }
+    }
+    clauses.resize(kept);
+
+    for (vector<int> &watchList: watches) {
+        size_t j = 0;
+        for (int index: watchList) {
+            if (newIndex[index] != NO_REASON) {
+                watchList[j++] = newIndex[index];
+            }
+        }
+        watchList.resize(j);
+    }
+    for (Literal lit: trail) {
+        int &reason = reasons[abs(lit)];
+        if (reason != NO_REASON) {
+            reason = newIndex[reason];
+        }
+    }
+}
+
+// Finite subsequence of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ... (x is 0-based).
+static double luby(int x) {
+    int size = 1, seq = 0;
+    while (size < x + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return pow(2.0, seq);
+}
+
+// Exponential moving averages of the learned clause LBD. Both start as plain
+// running means so neither is biased towards zero during warm-up.
+void Solver::updateLbdAverages(int lbd) {
+    double n = static_cast<double>(statistics.conflicts);
+    lbdFast += (lbd - lbdFast) * max(1.0 / n, 1.0 / 32);
+    lbdSlow += (lbd - lbdSlow) * max(1.0 / n, 1.0 / 4096);
+}
+
+bool Solver::shouldRestart() const {
+    switch (options.restart) {
+        case RESTART_LUBY:
+            return conflictsSinceRestart >= options.lubyUnit * luby(lubyIndex);
+        case RESTART_GLUCOSE:
+            return conflictsSinceRestart >= options.restartMinConflicts &&
+                   lbdFast > options.restartMargin * lbdSlow;
+        default:
+            return false;
+    }
+}
+
+void Solver::restart() {
+    cancelUntil(0);
+    statistics.restarts++;
+    conflictsSinceRestart = 0;
+    lubyIndex++;
+}
+
+bool Solver::cancelled() {
+    if (cancelFlag && cancelFlag->load(memory_order_relaxed)) {
+        wasInterrupted = true;
+        return true;
+    }
+    return false;
+}
+
+void Solver::exportClause(const IntClause &lits, int lbd) {
+    if (exchange && lits.size() <= static_cast<size_t>(ClauseExchange::MAX_LENGTH) && lbd <= 4) {
+        exchange->publish(exchangeId, lits);
+    }
+}
+
+// Adds the clauses other solvers published since the last call. Runs at level 0
+// right after a restart; returns false if they make the formula unsatisfiable.
+bool Solver::importClauses() {
+    if (!exchange) {
+        return true;
+    }
+    imported.clear();
+    exchange->collect(exchangeId, exchangeCursor, imported);
+    for (const IntClause &clause: imported) {
+        statistics.importedClauses++;
+        if (!insertClause(clause, true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pure literal rule: a literal whose negation occurs in no open input clause
+// can be made true without losing a model. Doing so satisfies its clauses,
+// which can make further literals pure, so occurrence counts are kept and the
+// rule runs to a fixpoint. Learned clauses are implied by the input ones and
+// are left out; variables of the caller's assumptions are never touched.
+void Solver::findPureLiterals() {
+    pureStart = assumptions.size();
+    vector<char> fixed(numVars + 1, 0);  // assumed or already pure
+    for (Literal lit: assumptions) {
+        fixed[abs(lit)] = 1;
+    }
+
+    vector<int> counts(watches.size(), 0);
+    vector<vector<int>> occurs(watches.size());
+    for (int i = 0; i < static_cast<int>(clauses.size()); ++i) {
+        const SolverClause &clause = clauses[i];
+        if (clause.learnt || clause.deleted) {
+            continue;
+        }
+        bool satisfied = false;
+        for (Literal lit: clause.lits) {
+            satisfied = satisfied || valueOf(lit) == VAL_TRUE;
+        }
+        if (satisfied) {
+            continue;
+        }
+        for (Literal lit: clause.lits) {
+            if (valueOf(lit) == VAL_UNASSIGNED) {
+                counts[watchIndex(lit)]++;
+                occurs[watchIndex(lit)].push_back(i);
+            }
+        }
+    }
+
+    vector<Literal> queue;
+    for (int var = 1; var <= numVars; ++var) {
+        if (values[var] != VAL_UNASSIGNED || fixed[var]) {
+            continue;
+        }
+        int positive = counts[watchIndex(var)], negative = counts[watchIndex(-var)];
+        if (positive > 0 && negative == 0) {
+            queue.push_back(var);
+        } else if (negative > 0 && positive == 0) {
+            queue.push_back(-var);
+        }
+    }
+
+    vector<char> satisfied(clauses.size(), 0);
+    while (!queue.empty()) {
+        Literal pure = queue.back();
+        queue.pop_back();
+        if (fixed[abs(pure)]) {
+            continue;
+        }
+        fixed[abs(pure)] = 1;
+        assumptions.push_back(pure);
+        statistics.pureLiterals++;
+        for (int index: occurs[watchIndex(pure)]) {
+            if (satisfied[index]) {
+                continue;
+            }
+            satisfied[index] = 1;
+            for (Literal lit: clauses[index].lits) {
+                if (valueOf(lit) == VAL_UNASSIGNED && --counts[watchIndex(lit)] == 0 &&
+                    counts[watchIndex(-lit)] > 0 && !fixed[abs(lit)]) {
+                    queue.push_back(-lit);
+                }
+            }
+        }
+    }
+}
+
+bool Solver::shouldProbe() const {
+    int root = static_cast<int>(assumptions.size());
+    if (!options.probing || decisionLevel() < root || decisionLevel() > root + options.probeLevels) {
+        return false;
+    }
+    // The root is only probed again once it has more assignments; deeper
+    // levels at every new node.
+    return decisionLevel() != probedLevel || trail.size() != probedTrail ||
+           (decisionLevel() != root && statistics.decisions != probedDecisions);
+}
+
+// Assigns literal on a temporary level (popped with cancelUntil) and propagates.
+int Solver::propagateProbe(Literal literal) {
+    statistics.probes++;
+    trailLimits.push_back(trail.size());
+    levelFlipped.push_back(true);
+    enqueue(literal, NO_REASON);
+    return propagate();
+}
+
+// failed led to conflict on the probe level. MODE_CDCL learns from it like
+// from any conflict, which asserts a literal, possibly after a backjump;
+// MODE_DPLL drops the probe level and sets -failed on the current one.
+int Solver::forceFailedLiteral(int conflict, Literal failed, IntClause &learnt) {
+    statistics.failedLiterals++;
+    if (options.mode == MODE_CDCL) {
+        learnFromConflict(conflict, learnt);
+    } else {
+        cancelUntil(decisionLevel() - 1, false);
+        enqueue(-failed, NO_REASON);
+    }
+    return propagate();
+}
+
+// One probing pass at the current node. Literals implied by both values of a
+// variable have no reason clause, so under MODE_CDCL they are only set at
+// level 0. Returns a conflict met while propagating the forced literals, to be
+// handled like any other, or NO_CONFLICT.
+int Solver::probeLiterals() {
+    int level = decisionLevel();
+    long long budgetEnd = statistics.propagations + options.probeBudget;
+    bool lookahead = options.mode == MODE_DPLL || level == 0;
+    vector<int8_t> impliedValues(numVars + 1, VAL_UNASSIGNED);
+    vector<Literal> implied, necessary;
+    IntClause learnt;
+
+    for (int var = 1; var <= numVars && statistics.propagations < budgetEnd; ++var) {
+        if (values[var] != VAL_UNASSIGNED || !order.contains(var)) {
+            continue;
+        }
+        int conflict = propagateProbe(var);
+        if (conflict != NO_CONFLICT) {
+            conflict = forceFailedLiteral(conflict, var, learnt);
+            if (conflict != NO_CONFLICT || decisionLevel() < level) {
+                return conflict;
+            }
+            continue;
+        }
+        implied.assign(trail.begin() + static_cast<long>(trailLimits.back()) + 1, trail.end());
+        cancelUntil(level, false);
+
+        conflict = propagateProbe(-var);
+        if (conflict != NO_CONFLICT) {
+            conflict = forceFailedLiteral(conflict, -var, learnt);
+            if (conflict != NO_CONFLICT || decisionLevel() < level) {
+                return conflict;
+            }
+            continue;
+        }
+        if (!lookahead) {
+            cancelUntil(level, false);
+            continue;
+        }
+        for (Literal lit: implied) {
+            impliedValues[abs(lit)] = lit > 0 ? VAL_TRUE : VAL_FALSE;
+        }
+        necessary.clear();
+        for (size_t i = trailLimits.back() + 1; i < trail.size(); ++i) {
+            if (impliedValues[abs(trail[i])] == values[abs(trail[i])]) {
+                necessary.push_back(trail[i]);
+            }
+        }
+        for (Literal lit: implied) {
+            impliedValues[abs(lit)] = VAL_UNASSIGNED;
+        }
+        cancelUntil(level, false);
+        if (!necessary.empty()) {
+            for (Literal lit: necessary) {
+                enqueue(lit, NO_REASON);
+            }
+            statistics.necessaryAssignments += static_cast<long long>(necessary.size());
+            conflict = propagate();
+            if (conflict != NO_CONFLICT) {
+                return conflict;
+            }
+        }
+    }
+    return NO_CONFLICT;
+}
+
+bool Solver::searchDpll() {
+    for (;;) {
+        if (cancelled()) {
+            return false;
+        }
+        int conflict = propagate();
+        if (conflict == NO_CONFLICT && shouldProbe()) {
+            conflict = probeLiterals();
+            probedLevel = decisionLevel();
+            probedTrail = trail.size();
+            probedDecisions = statistics.decisions;
+        }
+        if (conflict != NO_CONFLICT) {
+            statistics.conflicts++;
+            for (Literal lit: clauses[conflict].lits) {
+                bumpVar(abs(lit));
+            }
+            decayVarActivity();
+            if (decisionLevel() == 0) {
+                unsat = true;
+                return false;
+            }
+            if (decisionLevel() <= static_cast<int>(assumptions.size())) {
+                // Nothing but assumptions (and what they imply) is set.
+                analyzeFinal(clauses[conflict].lits);
+                return false;
+            }
+            if (!backtrack()) {
+                core.assign(assumptions.begin(), assumptions.begin() + static_cast<long>(pureStart));
+                coreAnalyzed = false;
+                return false;
+            }
+            continue;
+        }
+
+        Literal next;
+        if (!decideNext(next)) {
+            return false;
+        }
+        if (next == 0) {
+            return true;
+        }
+    }
+}
+
+// Learns the first-UIP clause of a conflict above level 0, jumps back and
+// asserts it.
+void Solver::learnFromConflict(int conflict, IntClause &learnt) {
+    statistics.conflicts++;
+    int backtrackLevel;
+    analyze(conflict, learnt, backtrackLevel);
+    int lbd = computeLbd(learnt);
+    conflictsSinceRestart++;
+    updateLbdAverages(lbd);
+    cancelUntil(backtrackLevel);
+    exportClause(learnt, lbd);
+
+    if (learnt.size() == 1) {
+        enqueue(learnt[0], NO_REASON);
+    } else {
+        int index = attachClause(learnt, true);
+        clauses[index].lbd = lbd;
+        bumpClause(clauses[index]);
+        numLearnts++;
+        statistics.learnedClauses++;
+        enqueue(learnt[0], index);
+    }
+    decayVarActivity();
+    clauseIncrement /= 0.999;
+}
+
+bool Solver::searchCdcl() {
+    IntClause learnt;
+    maxLearnts = max(clauses.size() / 3.0, 2000.0);
+
+    for (;;) {
+        if (cancelled()) {
+            return false;
+        }
+        int conflict = propagate();
+        if (conflict == NO_CONFLICT && shouldProbe()) {
+            conflict = probeLiterals();
+            probedLevel = decisionLevel();
+            probedTrail = trail.size();
+            probedDecisions = statistics.decisions;
+        }
+        if (conflict != NO_CONFLICT) {
+            if (decisionLevel() == 0) {
+                statistics.conflicts++;
+                unsat = true;
+                return false;
+            }
+            learnFromConflict(conflict, learnt);
+            continue;
+        }
+
+        if (shouldRestart()) {
+            restart();
+            if (!importClauses()) {
+                return false;
+            }
+        }
+
+        if (numLearnts >= maxLearnts + trail.size()) {
+            reduceLearnts();
+            maxLearnts *= 1.1;
+        }
+
+        Literal next;
+        if (!decideNext(next)) {
+            return false;
+        }
+        if (next == 0) {
+            return true;
+        }
+    }
+}
+
+void Solver::setCancelFlag(const atomic<bool> *flag) {
+    cancelFlag = flag;
+}
+
+void Solver::setClauseExchange(ClauseExchange *clauseExchange, int id) {
+    exchange = clauseExchange;
+    exchangeId = id;
+}
+
+bool Solver::solve() {
+    return solve(vector<Literal>());
+}
+
+bool Solver::solve(const vector<Literal> &assumptionLits) {
+    wasInterrupted = false;
+    cancelUntil(0);
+    assumptions = assumptionLits;
+    pureStart = assumptions.size();
+    core.clear();
+    coreAnalyzed = true;
+    probedLevel = -1;
+    if (unsat) {
+        return false;
+    }
+    if (options.pureLiterals) {
+        findPureLiterals();
+    }
+    return options.mode == MODE_CDCL ? searchCdcl() : searchDpll();
+}
+
+int Solver::probe(Literal literal) {
+    size_t before = trail.size();
+    decide(literal, true);
+    if (propagate() != NO_CONFLICT) {
+        return -1;
+    }
+    return static_cast<int>(trail.size() - before);
+}
+
+void Solver::popLevel() {
+    cancelUntil(decisionLevel() - 1);
+}
+
+bool Solver::isAssigned(int var) const {
+    return values[var] != VAL_UNASSIGNED;
+}
+
+const vector<Literal> &Solver::failedAssumptions() const {
+    return core;
+}
+
+bool Solver::failedAssumptionsAnalyzed() const {
+    return coreAnalyzed;
+}
+
+bool Solver::interrupted() const {
+    return wasInterrupted;
+}
+
+Model Solver::model() const {
+    return values;
+}
+
+const SolverStats &Solver::stats() const {
+    return statistics;
+}
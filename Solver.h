@@ -0,0 +1,186 @@
+#ifndef AILAB2_SOLVER_H
+#define AILAB2_SOLVER_H
+
+#include <atomic>
+#include <vector>
+#include "DPLL.h"
+#include "ActivityHeap.h"
+#include "ClauseExchange.h"
+
+using namespace std;
+
+// Clause database with two-watched-literal unit propagation. Clauses are stored
+// once and never copied; assignments are undone by popping the trail, which
+// leaves the watch lists valid. The search is an explicit loop over decision
+// levels, so memory stays O(variables + clauses) however deep it goes.
+//
+// MODE_DPLL backtracks chronologically. MODE_CDCL learns a first-UIP clause
+// from every conflict, jumps back to the second-highest level in it and
+// periodically drops learned clauses with high LBD / low activity.
+//
+// Branching is chosen by SolverOptions::heuristic; VSIDS activity is bumped for
+// every variable seen in conflict analysis (or in the conflict clause under
+// MODE_DPLL) and the last value of each variable is kept as its saved phase.
+// Restarts cancel every decision but keep learned clauses, activities and phases.
+//
+// solve() can take assumption literals: they are decided first, one per level,
+// and never flipped, so the answer is relative to them. Learned clauses do not
+// depend on assumptions and are kept for the next call. When there is no model
+// under the assumptions, failedAssumptions() gives a subset of them that
+// already rules every model out (the failed-assumption core).
+//
+// Two optional simplifications run inside the search:
+// - pure literals (SolverOptions::pureLiterals): at the start of solve(), every
+//   literal whose negation occurs in no input clause still open at level 0 is
+//   queued after the assumptions, one level each, so the assignment is
+//   withdrawn again before the next call;
+// - probing (SolverOptions::probing): on reaching a node at most probeLevels
+//   below the assumptions, both values of each open variable are propagated on
+//   a temporary level. A value that conflicts is a failed literal and its
+//   opposite is forced; a literal implied by both values is forced too
+//   (lookahead). Each pass stops after probeBudget propagations.
+//
+// For portfolio runs a solver can be given a cancel flag, polled once per search
+// step, and a ClauseExchange: short learned clauses are published to it as they
+// are learned, and clauses from the other solvers are added at each restart.
+class Solver {
+private:
+    struct SolverClause {
+        IntClause lits;  // lits[0] and lits[1] are the watched literals
+        bool learnt;
+        bool deleted;
+        int lbd;
+        double activity;
+    };
+
+    static const int NO_CONFLICT = -1;
+    static const int NO_REASON = -1;
+
+    SolverOptions options;
+    int numVars;
+    bool unsat;
+    vector<SolverClause> clauses;
+    vector<vector<int>> watches;  // watches[watchIndex(l)]: clauses watching l
+    vector<int8_t> values;
+    vector<int> levels;
+    vector<int> reasons;
+    vector<Literal> trail;
+    vector<size_t> trailLimits;  // trail size at the start of each decision level
+    vector<bool> levelFlipped;   // the level's decision is already the second branch
+    size_t propagateHead;
+    SolverStats statistics;
+
+    // Branching.
+    vector<double> activity;
+    ActivityHeap order;
+    double varIncrement;
+    vector<int8_t> savedPhases;
+
+    // Restarts (MODE_CDCL only). Saved phases survive a restart.
+    long long conflictsSinceRestart;
+    int lubyIndex;
+    double lbdFast;
+    double lbdSlow;
+
+    // Conflict analysis and learned clause management (MODE_CDCL only).
+    vector<char> seen;
+    vector<int> levelStamps;
+    int stamp;
+    size_t numLearnts;
+    double maxLearnts;
+    double clauseIncrement;
+
+    // Portfolio hooks.
+    const atomic<bool> *cancelFlag;
+    bool wasInterrupted;
+    ClauseExchange *exchange;
+    int exchangeId;
+    uint64_t exchangeCursor;
+    vector<IntClause> imported;
+
+    vector<Literal> assumptions;  // the caller's, then pure literals from pureStart
+    size_t pureStart;
+    vector<Literal> core;
+    bool coreAnalyzed;
+
+    // Probing: the node the last pass ran at, so it is not repeated there.
+    int probedLevel;
+    size_t probedTrail;
+    long long probedDecisions;
+
+    int watchIndex(Literal literal) const;
+    int8_t valueOf(Literal literal) const;
+    void enqueue(Literal literal, int reason);
+    void undoTo(size_t trailSize, bool savePhases = true);
+    int decisionLevel() const;
+    void decide(Literal literal, bool flipped);
+    void cancelUntil(int level, bool savePhases = true);
+    int attachClause(const IntClause &lits, bool learnt);
+    bool insertClause(const IntClause &clause, bool learnt);
+    int propagate();
+    bool decideNext(Literal &next);
+    Literal pickBranchLiteral();
+    Literal pickFirstLiteral() const;
+    Literal pickVsidsLiteral();
+    Literal pickMrvLiteral();
+    void bumpVar(int var);
+    void decayVarActivity();
+    bool backtrack();
+
+    void findPureLiterals();
+    bool shouldProbe() const;
+    int probeLiterals();
+    int propagateProbe(Literal literal);
+    int forceFailedLiteral(int conflict, Literal failed, IntClause &learnt);
+
+    void analyzeFinal(const IntClause &start);
+    void analyze(int conflict, IntClause &learnt, int &backtrackLevel);
+    bool literalRedundant(Literal literal, unsigned abstractLevels, vector<int> &toClear);
+    unsigned abstractLevel(int var) const;
+    int computeLbd(const IntClause &lits);
+    void bumpClause(SolverClause &clause);
+    bool locked(int index) const;
+    void reduceLearnts();
+    void removeDeletedClauses();
+    void learnFromConflict(int conflict, IntClause &learnt);
+
+    void updateLbdAverages(int lbd);
+    bool shouldRestart() const;
+    void restart();
+
+    bool cancelled();
+    void exportClause(const IntClause &lits, int lbd);
+    bool importClauses();
+
+    bool searchDpll();
+    bool searchCdcl();
+
+public:
+    explicit Solver(int numVars, const SolverOptions &options = SolverOptions());
+
+    bool addClause(const IntClause &clause);
+    void setCancelFlag(const atomic<bool> *flag);
+    void setClauseExchange(ClauseExchange *clauseExchange, int id);
+    // Returns false for UNSAT and when cancelled; interrupted() tells them apart.
+    bool solve();
+    bool solve(const vector<Literal> &assumptionLits);
+    bool interrupted() const;
+    // After solve() returned false: assumptions that together with the clauses
+    // are unsatisfiable. Empty when the clauses alone are, or when interrupted.
+    // Under MODE_DPLL a refutation that needed branching yields all of them,
+    // and failedAssumptionsAnalyzed() is false.
+    const vector<Literal> &failedAssumptions() const;
+    bool failedAssumptionsAnalyzed() const;
+
+    // Lookahead support (see CubeAndConquer.h). probe() decides literal on a new
+    // level and propagates; it returns how many literals got assigned, or -1 on
+    // a conflict. The level stays until popLevel().
+    int probe(Literal literal);
+    void popLevel();
+    bool isAssigned(int var) const;
+    Model model() const;
+    const SolverStats &stats() const;
+};
+
+
+#endif //AILAB2_SOLVER_H
@@ -3,31 +3,74 @@
 //
 
 #include "SudokuBoard.h"
+#include "SudokuGeometry.h"
 #include <stdexcept> // Include for std::out_of_range
+#include <string>
 
-SudokuBoard::SudokuBoard() {
-    for (int i = 0; i < 9; ++i)
-        for (int j = 0; j < 9; ++j)
+template <int BoxSize>
+SudokuGrid<BoxSize>::SudokuGrid() {
+    for (int i = 0; i < SIDE; ++i)
+        for (int j = 0; j < SIDE; ++j)
             board[i][j] = 0;  // Initialize with empty cells
 }
 
-void SudokuBoard::setCell(int row, int col, int val) {
-    board[row][col] = val;
+template <int BoxSize>
+void SudokuGrid<BoxSize>::setCell(int row, int col, int val) {
+    board[row][col] = static_cast<uint8_t>(val);
 }
 
-int SudokuBoard::getCell(int row, int col) const {
-    if (row > 0 && row <= 9 && col > 0 && col <= 9) {
+template <int BoxSize>
+int SudokuGrid<BoxSize>::getCell(int row, int col) const {
+    if (row > 0 && row <= SIDE && col > 0 && col <= SIDE) {
         return board[row - 1][col - 1];
     } else {
-        throw std::out_of_range("Row and Column indices should be between 1 and 9 (inclusive).");
+        throw std::out_of_range("Row and Column indices should be between 1 and " + to_string(SIDE) +
+                                " (inclusive).");
     }
 }
 
-void SudokuBoard::printBoard() const {
-    for (int i = 0; i < 9; ++i) {
-        for (int j = 0; j < 9; ++j) {
-            cout << board[i][j] << " ";
+template <int BoxSize>
+void SudokuGrid<BoxSize>::printBoard() const {
+    for (int i = 0; i < SIDE; ++i) {
+        for (int j = 0; j < SIDE; ++j) {
+            cout << static_cast<int>(board[i][j]) << " ";
         }
         cout << "\n";
     }
 }
+
+template <int BoxSize>
+bool isValidSolution(const SudokuGrid<BoxSize> &solution, const SudokuGrid<BoxSize> &givens) {
+    using Geometry = SudokuGeometry<BoxSize>;
+    const Geometry &geometry = sudokuGeometry<BoxSize>;
+    for (int u = 0; u < Geometry::UNITS; ++u) {
+        typename Geometry::Mask seen = 0;
+        for (int cell: geometry.units[u]) {
+            int value = solution.board[cell / Geometry::SIDE][cell % Geometry::SIDE];
+            if (value < 1 || value > Geometry::SIDE) {
+                return false;
+            }
+            seen |= 1u << (value - 1);
+        }
+        if (seen != Geometry::ALL_DIGITS) {
+            return false;
+        }
+    }
+    for (int row = 0; row < Geometry::SIDE; ++row) {
+        for (int col = 0; col < Geometry::SIDE; ++col) {
+            int given = givens.board[row][col];
+            if (given && given != solution.board[row][col]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template class SudokuGrid<3>;
+template class SudokuGrid<4>;
+template class SudokuGrid<5>;
+
+template bool isValidSolution<3>(const SudokuGrid<3> &, const SudokuGrid<3> &);
+template bool isValidSolution<4>(const SudokuGrid<4> &, const SudokuGrid<4> &);
+template bool isValidSolution<5>(const SudokuGrid<5> &, const SudokuGrid<5> &);
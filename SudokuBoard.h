@@ -6,23 +6,36 @@
 #define AILAB2_SUDOKUBOARD_H
 
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
 using namespace std;
 
-class SudokuBoard {
+// An N^2 x N^2 board with N = BoxSize; instantiated for box sizes 3, 4 and 5
+// (9x9, 16x16 and 25x25).
+template <int BoxSize>
+class SudokuGrid {
 private:
     //int board[9][9];
 
 public:
-    int board[9][9];
-    SudokuBoard();
+    static const int SIDE = BoxSize * BoxSize;
+
+    uint8_t board[SIDE][SIDE];  // one byte per cell keeps a 9x9 board in 81 bytes
+    SudokuGrid();
 
     void setCell(int row, int col, int val);
     int getCell(int row, int col) const;
     void printBoard() const;
 };
 
+using SudokuBoard = SudokuGrid<3>;
+
+// True if solution is complete, every row, column and box holds each digit once,
+// and it agrees with every given of givens.
+template <int BoxSize>
+bool isValidSolution(const SudokuGrid<BoxSize> &solution, const SudokuGrid<BoxSize> &givens);
+
 
 #endif //AILAB2_SUDOKUBOARD_H
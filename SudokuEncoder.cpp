@@ -0,0 +1,281 @@
+#include "SudokuEncoder.h"
+#include "SudokuGeometry.h"
+
+// used[cell] has bit num-1 set when a given peer of the cell holds num.
+// Returns false if two givens contradict each other.
+template <int BoxSize>
+static bool givenPeerDigits(const SudokuGrid<BoxSize> &board, typename SudokuGeometry<BoxSize>::Mask *used) {
+    using Geometry = SudokuGeometry<BoxSize>;
+    const Geometry &geometry = sudokuGeometry<BoxSize>;
+    bool consistent = true;
+    for (int cell = 0; cell < Geometry::CELLS; ++cell) {
+        used[cell] = 0;
+    }
+    for (int cell = 0; cell < Geometry::CELLS; ++cell) {
+        int num = board.board[geometry.row[cell]][geometry.col[cell]];
+        if (!num) {
+            continue;
+        }
+        for (int peer: geometry.peers[cell]) {
+            if (board.board[geometry.row[peer]][geometry.col[peer]] == num) {
+                consistent = false;
+            }
+            used[peer] |= 1u << (num - 1);
+        }
+    }
+    return consistent;
+}
+
+template <int BoxSize>
+IntFormula encodeSudoku(const SudokuGrid<BoxSize> &board) {
+    const int side = SudokuGeometry<BoxSize>::SIDE;
+    IntFormula formula;
+    formula.reserve(SudokuGeometry<BoxSize>::CELLS * (1 + side * SudokuGeometry<BoxSize>::PEERS / 2) +
+                    SudokuGeometry<BoxSize>::CELLS);
+
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
+            // 1) At least one digit in a box
+            IntClause cell;
+            for (int num = 1; num <= side; ++num) {
+                cell.push_back(sudokuVariable<BoxSize>(num, row, col));
+            }
+            formula.push_back(cell);
+
+            // Each pair of peers is emitted once, from the cell that comes first.
+            for (int num = 1; num <= side; ++num) {
+                int var = sudokuVariable<BoxSize>(num, row, col);
+                // 2) Unique row
+                for (int otherCol = col + 1; otherCol <= side; ++otherCol) {
+                    formula.push_back({-var, -sudokuVariable<BoxSize>(num, row, otherCol)});
+                }
+                // 3) Unique column
+                for (int otherRow = row + 1; otherRow <= side; ++otherRow) {
+                    formula.push_back({-var, -sudokuVariable<BoxSize>(num, otherRow, col)});
+                }
+                // 4) Unique box, skipping the pairs already covered by row and column
+                int startRow = (row - 1) / BoxSize * BoxSize + 1;
+                int startCol = (col - 1) / BoxSize * BoxSize + 1;
+                for (int r = row + 1; r < startRow + BoxSize; ++r) {
+                    for (int c = startCol; c < startCol + BoxSize; ++c) {
+                        if (c != col) {
+                            formula.push_back({-var, -sudokuVariable<BoxSize>(num, r, c)});
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 5) Initial board
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
+            int cellValue = board.getCell(row, col);
+            if (cellValue) {
+                formula.push_back({sudokuVariable<BoxSize>(cellValue, row, col)});
+            }
+        }
+    }
+
+    return formula;
+}
+
+template <int BoxSize>
+IntFormula encodeSudokuReduced(const SudokuGrid<BoxSize> &board) {
+    using Geometry = SudokuGeometry<BoxSize>;
+    const Geometry &geometry = sudokuGeometry<BoxSize>;
+    IntFormula formula;
+    typename Geometry::Mask used[Geometry::CELLS];
+    if (!givenPeerDigits(board, used)) {
+        formula.push_back({});
+        return formula;
+    }
+
+    auto isCandidate = [&](int num, int cell) {
+        return board.board[geometry.row[cell]][geometry.col[cell]] == 0 && !(used[cell] & (1u << (num - 1)));
+    };
+
+    for (int cell = 0; cell < Geometry::CELLS; ++cell) {
+        int row = geometry.row[cell] + 1, col = geometry.col[cell] + 1;
+        if (board.getCell(row, col)) {
+            continue;
+        }
+        // 1) At least one remaining candidate (empty if none is left)
+        IntClause candidates;
+        for (int num = 1; num <= Geometry::SIDE; ++num) {
+            if (isCandidate(num, cell)) {
+                candidates.push_back(sudokuVariable<BoxSize>(num, row, col));
+            }
+        }
+        formula.push_back(candidates);
+
+        // 2-4) At most one per row, column and box, among candidates only. Peers
+        // are listed in cell order, so each pair comes from its first cell.
+        for (int num = 1; num <= Geometry::SIDE; ++num) {
+            if (!isCandidate(num, cell)) {
+                continue;
+            }
+            int var = sudokuVariable<BoxSize>(num, row, col);
+            for (int peer: geometry.peers[cell]) {
+                if (peer > cell && isCandidate(num, peer)) {
+                    formula.push_back({-var, -sudokuVariable<BoxSize>(num, geometry.row[peer] + 1,
+                                                                       geometry.col[peer] + 1)});
+                }
+            }
+        }
+    }
+    return formula;
+}
+
+template <int BoxSize>
+vector<IntClause> sudokuCells() {
+    const int side = SudokuGeometry<BoxSize>::SIDE;
+    vector<IntClause> cells;
+    cells.reserve(SudokuGeometry<BoxSize>::CELLS);
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
+            IntClause cell;
+            for (int num = 1; num <= side; ++num) {
+                cell.push_back(sudokuVariable<BoxSize>(num, row, col));
+            }
+            cells.push_back(cell);
+        }
+    }
+    return cells;
+}
+
+template <int BoxSize>
+vector<IntClause> sudokuCandidates(const SudokuGrid<BoxSize> &board) {
+    using Geometry = SudokuGeometry<BoxSize>;
+    const Geometry &geometry = sudokuGeometry<BoxSize>;
+    vector<IntClause> cells;
+    typename Geometry::Mask used[Geometry::CELLS];
+    givenPeerDigits(board, used);
+    for (int cell = 0; cell < Geometry::CELLS; ++cell) {
+        int row = geometry.row[cell] + 1, col = geometry.col[cell] + 1;
+        if (board.getCell(row, col)) {
+            continue;
+        }
+        IntClause candidates;
+        for (int num = 1; num <= Geometry::SIDE; ++num) {
+            if (!(used[cell] & (1u << (num - 1)))) {
+                candidates.push_back(sudokuVariable<BoxSize>(num, row, col));
+            }
+        }
+        cells.push_back(candidates);
+    }
+    return cells;
+}
+
+template <int BoxSize>
+SudokuGrid<BoxSize> decodeSudoku(const Model &model, const SudokuGrid<BoxSize> &givens) {
+    const int side = SudokuGeometry<BoxSize>::SIDE;
+    SudokuGrid<BoxSize> solution = givens;
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
+            if (givens.getCell(row, col)) {
+                continue;
+            }
+            for (int num = 1; num <= side; ++num) {
+                if (model[sudokuVariable<BoxSize>(num, row, col)] == VAL_TRUE) {
+                    solution.setCell(row - 1, col - 1, num);
+                    break;
+                }
+            }
+        }
+    }
+    return solution;
+}
+
+template <int BoxSize>
+bool solveSudokuSat(const SudokuGrid<BoxSize> &givens, bool reduced, SolverOptions options,
+                    SudokuGrid<BoxSize> &solution, SolverStats *stats) {
+    IntFormula formula;
+    if (reduced) {
+        formula = encodeSudokuReduced(givens);
+        options.mrvGroups = sudokuCandidates(givens);
+    } else {
+        formula = encodeSudoku(givens);
+        options.mrvGroups = sudokuCells<BoxSize>();
+    }
+
+    Model model = dpll(formula, sudokuVariableCount<BoxSize>(), options, stats);
+    if (model.empty()) {
+        return false;
+    }
+    solution = decodeSudoku(model, givens);
+    return true;
+}
+
+template <int BoxSize>
+static SolverOptions withCellGroups(SolverOptions options) {
+    options.mrvGroups = sudokuCells<BoxSize>();
+    return options;
+}
+
+template <int BoxSize>
+IncrementalSudokuSolver<BoxSize>::IncrementalSudokuSolver(const SolverOptions &options)
+        : solver(sudokuVariableCount<BoxSize>(), withCellGroups<BoxSize>(options)) {
+    for (const IntClause &clause: encodeSudoku(SudokuGrid<BoxSize>())) {
+        solver.addClause(clause);
+    }
+}
+
+template <int BoxSize>
+bool IncrementalSudokuSolver<BoxSize>::solve(const SudokuGrid<BoxSize> &givens, SudokuGrid<BoxSize> &solution) {
+    const int side = SudokuGeometry<BoxSize>::SIDE;
+    assumptions.clear();
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
+            if (givens.getCell(row, col)) {
+                assumptions.push_back(sudokuVariable<BoxSize>(givens.getCell(row, col), row, col));
+            }
+        }
+    }
+
+    conflicting = SudokuGrid<BoxSize>();
+    if (!solver.solve(assumptions)) {
+        if (!solver.failedAssumptionsAnalyzed()) {
+            return false;
+        }
+        for (Literal given: solver.failedAssumptions()) {
+            int cell = (given - 1) / side;
+            conflicting.setCell(cell / side, cell % side, (given - 1) % side + 1);
+        }
+        return false;
+    }
+    solution = decodeSudoku(solver.model(), givens);
+    return true;
+}
+
+template <int BoxSize>
+const SudokuGrid<BoxSize> &IncrementalSudokuSolver<BoxSize>::conflictingGivens() const {
+    return conflicting;
+}
+
+template <int BoxSize>
+const SolverStats &IncrementalSudokuSolver<BoxSize>::stats() const {
+    return solver.stats();
+}
+
+template IntFormula encodeSudoku<3>(const SudokuGrid<3> &);
+template IntFormula encodeSudoku<4>(const SudokuGrid<4> &);
+template IntFormula encodeSudoku<5>(const SudokuGrid<5> &);
+template IntFormula encodeSudokuReduced<3>(const SudokuGrid<3> &);
+template IntFormula encodeSudokuReduced<4>(const SudokuGrid<4> &);
+template IntFormula encodeSudokuReduced<5>(const SudokuGrid<5> &);
+template vector<IntClause> sudokuCells<3>();
+template vector<IntClause> sudokuCells<4>();
+template vector<IntClause> sudokuCells<5>();
+template vector<IntClause> sudokuCandidates<3>(const SudokuGrid<3> &);
+template vector<IntClause> sudokuCandidates<4>(const SudokuGrid<4> &);
+template vector<IntClause> sudokuCandidates<5>(const SudokuGrid<5> &);
+template SudokuGrid<3> decodeSudoku<3>(const Model &, const SudokuGrid<3> &);
+template SudokuGrid<4> decodeSudoku<4>(const Model &, const SudokuGrid<4> &);
+template SudokuGrid<5> decodeSudoku<5>(const Model &, const SudokuGrid<5> &);
+template bool solveSudokuSat<3>(const SudokuGrid<3> &, bool, SolverOptions, SudokuGrid<3> &, SolverStats *);
+template bool solveSudokuSat<4>(const SudokuGrid<4> &, bool, SolverOptions, SudokuGrid<4> &, SolverStats *);
+template bool solveSudokuSat<5>(const SudokuGrid<5> &, bool, SolverOptions, SudokuGrid<5> &, SolverStats *);
+template class IncrementalSudokuSolver<3>;
+template class IncrementalSudokuSolver<4>;
+template class IncrementalSudokuSolver<5>;
@@ -0,0 +1,81 @@
+#ifndef AILAB2_SUDOKUENCODER_H
+#define AILAB2_SUDOKUENCODER_H
+
+#include "DPLL.h"
+#include "Solver.h"
+#include "SudokuBoard.h"
+
+// Integer encoding of the same constraints sudokuConstraints() writes as
+// strings: one at-least-one clause per cell, one binary at-most-one clause per
+// pair of peers sharing a digit, and a unit clause per given. Clauses come out in
+// the order CNFConverter produces them, with the duplicate pairs already removed.
+//
+// Everything is templated on the box size and instantiated for 3, 4 and 5; the
+// argument is deduced from the board, and defaults to 3 where there is none.
+
+// Variable id of "digit num at (row, col)", all 1-based.
+template <int BoxSize = 3>
+constexpr int sudokuVariable(int num, int row, int col) {
+    return ((row - 1) * BoxSize * BoxSize + (col - 1)) * BoxSize * BoxSize + num;
+}
+
+template <int BoxSize>
+constexpr int sudokuVariableCount() {
+    return BoxSize * BoxSize * BoxSize * BoxSize * BoxSize * BoxSize;
+}
+
+template <int BoxSize>
+IntFormula encodeSudoku(const SudokuGrid<BoxSize> &board);
+
+// Same constraints simplified against the givens: given cells and digits ruled
+// out by a given peer get no variables at all, so only the remaining candidates
+// appear. Contradicting givens yield an empty clause.
+template <int BoxSize>
+IntFormula encodeSudokuReduced(const SudokuGrid<BoxSize> &board);
+
+// The candidate variables of every cell, for HEURISTIC_MRV.
+template <int BoxSize = 3>
+vector<IntClause> sudokuCells();
+
+// The candidate variables of every empty cell after removing digits used by a
+// given peer; the MRV groups matching encodeSudokuReduced().
+template <int BoxSize>
+vector<IntClause> sudokuCandidates(const SudokuGrid<BoxSize> &board);
+
+// Fills the empty cells of givens from a model of either encoding.
+template <int BoxSize>
+SudokuGrid<BoxSize> decodeSudoku(const Model &model, const SudokuGrid<BoxSize> &givens);
+
+// Encodes, runs dpll() with the cells as MRV groups and decodes. Returns false if
+// the puzzle has no solution.
+template <int BoxSize>
+bool solveSudokuSat(const SudokuGrid<BoxSize> &givens, bool reduced, SolverOptions options,
+                    SudokuGrid<BoxSize> &solution, SolverStats *stats = nullptr);
+
+// Solves a stream of puzzles on one Solver that is loaded once with the clauses
+// all of them share (encodeSudoku() of an empty grid, cells as MRV groups).
+// The givens are passed as assumptions, so nothing is re-encoded per puzzle,
+// and learned clauses, activities and saved phases carry over to the next one.
+// Not copyable: the Solver's heap refers to its own activity vector.
+template <int BoxSize = 3>
+class IncrementalSudokuSolver {
+private:
+    Solver solver;
+    vector<Literal> assumptions;
+    SudokuGrid<BoxSize> conflicting;
+
+public:
+    explicit IncrementalSudokuSolver(const SolverOptions &options);
+    IncrementalSudokuSolver(const IncrementalSudokuSolver &) = delete;
+    IncrementalSudokuSolver &operator=(const IncrementalSudokuSolver &) = delete;
+
+    // Returns false if the puzzle has no solution; conflictingGivens() then
+    // holds a subset of its givens that already has none, or nothing when the
+    // search cannot tell (MODE_DPLL, if proving it took branching).
+    bool solve(const SudokuGrid<BoxSize> &givens, SudokuGrid<BoxSize> &solution);
+    const SudokuGrid<BoxSize> &conflictingGivens() const;
+    // Totals over every puzzle solved so far.
+    const SolverStats &stats() const;
+};
+
+#endif //AILAB2_SUDOKUENCODER_H
@@ -0,0 +1,261 @@
+#include "SudokuEngine.h"
+#include "SudokuGeometry.h"
+
+namespace {
+    const uint16_t ALL_DIGITS = 0x1FF;
+
+    // The shared 9x9 geometry plus the slot of each cell in the kernel grid,
+    // all computed at compile time.
+    struct Geometry : SudokuGeometry<3> {
+        int slot[81];
+
+        constexpr Geometry() : SudokuGeometry<3>(), slot() {
+            for (int cell = 0; cell < 81; ++cell) {
+                slot[cell] = row[cell] * KERNEL_LANES + col[cell];
+            }
+        }
+    };
+
+    constexpr Geometry geometry{};
+
+    int popcount(uint16_t mask) {
+        return __builtin_popcount(mask);
+    }
+}
+
+SudokuEngine::SudokuEngine(KernelKind kind) : kernel(selectEliminateKernel(kind)), guesses(0) {
+}
+
+long long SudokuEngine::guessCount() const {
+    return guesses;
+}
+
+const char *SudokuEngine::kernelName() const {
+    return eliminateKernelName(kernel);
+}
+
+bool SudokuEngine::isOpen(const State &state, int cell) {
+    return !(state.cells[geometry.slot[cell]] & KERNEL_PLACED);
+}
+
+// Removes mask from an open cell. Returns false if the cell runs out of candidates.
+bool SudokuEngine::eliminate(State &state, int cell, uint16_t mask, bool &changed) {
+    uint16_t &candidates = state.cells[geometry.slot[cell]];
+    if ((candidates & mask) && !(candidates & KERNEL_PLACED)) {
+        candidates &= ~mask;
+        changed = true;
+        return candidates != 0;
+    }
+    return true;
+}
+
+// Puts the digit bit into cell and marks it used in the cell's units. Peers keep
+// the digit until the next kernel pass.
+bool SudokuEngine::place(State &state, int cell, uint16_t bit) {
+    int r = geometry.row[cell], c = geometry.col[cell], b = geometry.box[cell];
+    uint16_t &candidates = state.cells[geometry.slot[cell]];
+    if (!(candidates & bit) || ((state.rows[r] | state.cols[c] | state.boxes[b]) & bit)) {
+        return false;
+    }
+    candidates = bit | KERNEL_PLACED;
+    state.rows[r] |= bit;
+    state.cols[c] |= bit;
+    state.boxes[b] |= bit;
+    state.unsolved--;
+    return true;
+}
+
+// Places the hidden singles the kernel found in unit u. Singles from the same
+// pass can clash with each other; place() rejects the second one through the
+// unit masks, and a digit another single already put here is skipped.
+bool SudokuEngine::hiddenSingles(State &state, int u, uint16_t digits, bool &changed) {
+    const int *unit = geometry.units[u];
+    while (digits) {
+        uint16_t bit = digits & -digits;
+        digits ^= bit;
+        uint16_t placed = u < 9 ? state.rows[u] : u < 18 ? state.cols[u - 9] : state.boxes[u - 18];
+        if (placed & bit) {
+            continue;
+        }
+        for (int i = 0; i < 9; ++i) {
+            if (state.cells[geometry.slot[unit[i]]] & bit) {
+                if (!place(state, unit[i], bit)) {
+                    return false;
+                }
+                changed = true;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// Cell at position pos along a row (axis 0) or column (axis 1).
+static int cellAt(int axis, int line, int pos) {
+    return axis == 0 ? line * 9 + pos : pos * 9 + line;
+}
+
+// Pointing and claiming. For every row (and column) the candidates are split into
+// three segments, one per box it crosses. A digit confined to one segment within
+// its box is removed from the rest of the line; a digit confined to one segment
+// within its line is removed from the rest of the box.
+bool SudokuEngine::lockedCandidates(State &state, bool &changed) {
+    for (int axis = 0; axis < 2; ++axis) {
+        // segments[line][k]: unplaced candidates of the line within the k-th box it crosses
+        uint16_t segments[9][3];
+        for (int line = 0; line < 9; ++line) {
+            for (int k = 0; k < 3; ++k) {
+                uint16_t mask = 0;
+                for (int j = 0; j < 3; ++j) {
+                    int cell = cellAt(axis, line, k * 3 + j);
+                    if (isOpen(state, cell)) {
+                        mask |= state.cells[geometry.slot[cell]];
+                    }
+                }
+                segments[line][k] = mask;
+            }
+        }
+
+        for (int line = 0; line < 9; ++line) {
+            int band = line / 3;
+            for (int k = 0; k < 3; ++k) {
+                uint16_t segment = segments[line][k];
+
+                // Pointing: only this line carries the digit inside box (band, k).
+                uint16_t otherLines = 0;
+                for (int t = 0; t < 3; ++t) {
+                    if (band * 3 + t != line) {
+                        otherLines |= segments[band * 3 + t][k];
+                    }
+                }
+                uint16_t pointing = segment & ~otherLines;
+
+                // Claiming: only box (band, k) carries the digit along this line.
+                uint16_t otherBoxes = segments[line][(k + 1) % 3] | segments[line][(k + 2) % 3];
+                uint16_t claiming = segment & ~otherBoxes;
+
+                for (int pos = 0; pointing && pos < 9; ++pos) {
+                    if (pos / 3 != k && !eliminate(state, cellAt(axis, line, pos), pointing, changed)) {
+                        return false;
+                    }
+                }
+                for (int t = 0; claiming && t < 3; ++t) {
+                    if (band * 3 + t == line) {
+                        continue;
+                    }
+                    for (int j = 0; j < 3; ++j) {
+                        if (!eliminate(state, cellAt(axis, band * 3 + t, k * 3 + j), claiming, changed)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Each round starts with a kernel pass, which clears placed digits from their
+// peers and reports the naked and hidden singles of the resulting grid.
+bool SudokuEngine::propagate(State &state, bool locked) const {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        KernelSingles singles;
+        if (!kernel(state.cells, state.rows, state.cols, state.boxes, singles)) {
+            return false;
+        }
+        if (!state.unsolved) {
+            return true;
+        }
+
+        for (int r = 0; r < 9; ++r) {
+            for (uint16_t lanes = singles.naked[r]; lanes; lanes &= lanes - 1) {
+                int cell = r * 9 + __builtin_ctz(lanes);
+                if (!place(state, cell, state.cells[geometry.slot[cell]])) {
+                    return false;
+                }
+                changed = true;
+            }
+        }
+        for (int u = 0; u < 27; ++u) {
+            if (singles.hidden[u] && !hiddenSingles(state, u, singles.hidden[u], changed)) {
+                return false;
+            }
+        }
+        if (changed) {
+            continue;
+        }
+
+        if (locked && !lockedCandidates(state, changed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Locked candidates only run at the root: below it they rarely save a guess and
+// cost more than the singles passes combined.
+bool SudokuEngine::search(State &state, State &result, int depth) {
+    if (!propagate(state, depth == 0)) {
+        return false;
+    }
+    if (!state.unsolved) {
+        result = state;
+        return true;
+    }
+
+    // Minimum remaining values: branch on the open cell with the fewest candidates.
+    int best = -1, bestCount = 10;
+    for (int cell = 0; cell < 81 && bestCount > 2; ++cell) {
+        uint16_t mask = state.cells[geometry.slot[cell]];
+        if (mask & KERNEL_PLACED) {
+            continue;
+        }
+        int count = popcount(mask);
+        if (count < bestCount) {
+            best = cell;
+            bestCount = count;
+        }
+    }
+
+    uint16_t candidates = state.cells[geometry.slot[best]];
+    while (candidates) {
+        uint16_t bit = candidates & -candidates;
+        candidates ^= bit;
+        guesses++;
+        State next = state;
+        if (place(next, best, bit) && search(next, result, depth + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SudokuEngine::solve(const SudokuBoard &givens, SudokuBoard &solution) {
+    State state;
+    for (int slot = 0; slot < 9 * KERNEL_LANES; ++slot) {
+        state.cells[slot] = slot % KERNEL_LANES < 9 ? ALL_DIGITS : KERNEL_PLACED;
+    }
+    for (int i = 0; i < 9; ++i) {
+        state.rows[i] = state.cols[i] = state.boxes[i] = 0;
+    }
+    state.unsolved = 81;
+
+    for (int cell = 0; cell < 81; ++cell) {
+        int value = givens.getCell(cell / 9 + 1, cell % 9 + 1);
+        if (value && !place(state, cell, static_cast<uint16_t>(1 << (value - 1)))) {
+            return false;
+        }
+    }
+
+    State result;
+    if (!search(state, result, 0)) {
+        return false;
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+        solution.setCell(cell / 9, cell % 9, __builtin_ctz(result.cells[geometry.slot[cell]] & ALL_DIGITS) + 1);
+    }
+    return true;
+}
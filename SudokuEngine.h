@@ -0,0 +1,46 @@
+#ifndef AILAB2_SUDOKUENGINE_H
+#define AILAB2_SUDOKUENGINE_H
+
+#include <cstdint>
+#include "SudokuBoard.h"
+#include "SudokuKernel.h"
+
+// Dedicated 9x9 solver that works on candidate bitmasks instead of clauses.
+// Every cell keeps a 9-bit candidate mask and every row, column and box a mask
+// of the digits already placed in it. Propagation applies naked singles, hidden
+// singles and locked candidates (pointing and claiming, root only) with bit
+// operations; search is MRV backtracking over copies of the fixed-size State.
+// Placing a digit only updates the unit masks; the SIMD kernel then clears it
+// from every peer in one pass over the grid.
+class SudokuEngine {
+private:
+    // Six cache lines: the kernel grid (9 rows of 16 lanes) plus the unit masks.
+    struct alignas(64) State {
+        uint16_t cells[9 * KERNEL_LANES];  // bit d-1 set: digit d is still possible
+        uint16_t rows[9];                  // digits placed in each row
+        uint16_t cols[9];
+        uint16_t boxes[9];
+        uint8_t unsolved;                  // open cells left
+    };
+
+    EliminateKernel kernel;
+    long long guesses;
+
+    static bool isOpen(const State &state, int cell);
+    static bool eliminate(State &state, int cell, uint16_t mask, bool &changed);
+    static bool place(State &state, int cell, uint16_t bit);
+    static bool hiddenSingles(State &state, int unit, uint16_t digits, bool &changed);
+    static bool lockedCandidates(State &state, bool &changed);
+    bool propagate(State &state, bool locked) const;
+    bool search(State &state, State &result, int depth);
+
+public:
+    explicit SudokuEngine(KernelKind kind = KERNEL_AUTO);
+
+    // Returns false when the givens have no solution.
+    bool solve(const SudokuBoard &givens, SudokuBoard &solution);
+    long long guessCount() const;
+    const char *kernelName() const;
+};
+
+#endif //AILAB2_SUDOKUENGINE_H
@@ -0,0 +1,56 @@
+#ifndef AILAB2_SUDOKUGEOMETRY_H
+#define AILAB2_SUDOKUGEOMETRY_H
+
+#include <cstdint>
+#include <type_traits>
+
+// Cell geometry of an N^2 x N^2 grid with N = BoxSize, computed at compile
+// time. Cells are numbered row by row from 0; units are the rows, then the
+// columns, then the boxes; peers are the other cells sharing a unit.
+template <int BoxSize>
+struct SudokuGeometry {
+    static constexpr int SIDE = BoxSize * BoxSize;
+    static constexpr int CELLS = SIDE * SIDE;
+    static constexpr int UNITS = 3 * SIDE;
+    static constexpr int PEERS = 2 * (SIDE - 1) + (BoxSize - 1) * (BoxSize - 1);
+
+    // Smallest unsigned type with a bit per digit (bit d-1 for digit d).
+    using Mask = typename std::conditional<(SIDE <= 16), uint16_t, uint32_t>::type;
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((1ULL << SIDE) - 1);
+
+    int row[CELLS];
+    int col[CELLS];
+    int box[CELLS];
+    int units[UNITS][SIDE];
+    int peers[CELLS][PEERS];
+
+    constexpr SudokuGeometry() : row(), col(), box(), units(), peers() {
+        for (int cell = 0; cell < CELLS; ++cell) {
+            row[cell] = cell / SIDE;
+            col[cell] = cell % SIDE;
+            box[cell] = row[cell] / BoxSize * BoxSize + col[cell] / BoxSize;
+        }
+        for (int i = 0; i < SIDE; ++i) {
+            for (int j = 0; j < SIDE; ++j) {
+                units[i][j] = i * SIDE + j;
+                units[SIDE + i][j] = j * SIDE + i;
+                units[2 * SIDE + i][j] = (i / BoxSize * BoxSize + j / BoxSize) * SIDE + i % BoxSize * BoxSize +
+                                         j % BoxSize;
+            }
+        }
+        for (int cell = 0; cell < CELLS; ++cell) {
+            int count = 0;
+            for (int other = 0; other < CELLS; ++other) {
+                if (other != cell && (row[other] == row[cell] || col[other] == col[cell] ||
+                                      box[other] == box[cell])) {
+                    peers[cell][count++] = other;
+                }
+            }
+        }
+    }
+};
+
+template <int BoxSize>
+constexpr SudokuGeometry<BoxSize> sudokuGeometry{};
+
+#endif //AILAB2_SUDOKUGEOMETRY_H
@@ -0,0 +1,254 @@
+#include "SudokuKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SUDOKU_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+const uint16_t KERNEL_DIGITS = 0x1FF;
+
+// Adds the digits of one cell (or a lane-wise group of cells) to the running
+// once/twice masks of a unit: twice collects digits seen at least twice.
+static inline void countDigits(uint16_t &once, uint16_t &twice, uint16_t digits) {
+    twice |= once & digits;
+    once |= digits;
+}
+
+// Turns per-unit once/twice masks into hidden singles. A unit in which some
+// digit fits nowhere (placed cells included) has no solution.
+static bool collectHidden(const uint16_t *once, const uint16_t *twice, const uint16_t *rows,
+                          const uint16_t *cols, const uint16_t *boxes, KernelSingles &singles) {
+    for (int u = 0; u < 27; ++u) {
+        if (once[u] != KERNEL_DIGITS) {
+            return false;
+        }
+        uint16_t placed = u < 9 ? rows[u] : u < 18 ? cols[u - 9] : boxes[u - 18];
+        singles.hidden[u] = once[u] & ~twice[u] & ~placed;
+    }
+    return true;
+}
+
+static bool eliminateScalar(uint16_t *cells, const uint16_t *rows, const uint16_t *cols, const uint16_t *boxes,
+                            KernelSingles &singles) {
+    uint16_t once[27] = {}, twice[27] = {};
+    for (int r = 0; r < 9; ++r) {
+        uint16_t naked = 0;
+        for (int c = 0; c < 9; ++c) {
+            int b = r / 3 * 3 + c / 3;
+            uint16_t &cell = cells[r * KERNEL_LANES + c];
+            if (!(cell & KERNEL_PLACED)) {
+                cell &= ~(rows[r] | cols[c] | boxes[b]);
+                if (!cell) {
+                    return false;
+                }
+                if (!(cell & (cell - 1))) {
+                    naked |= 1 << c;
+                }
+            }
+            uint16_t digits = cell & KERNEL_DIGITS;
+            countDigits(once[r], twice[r], digits);
+            countDigits(once[9 + c], twice[9 + c], digits);
+            countDigits(once[18 + b], twice[18 + b], digits);
+        }
+        singles.naked[r] = naked;
+    }
+    return collectHidden(once, twice, rows, cols, boxes, singles);
+}
+
+#ifdef SUDOKU_KERNEL_X86
+
+// Box masks of one band spread over the lanes: lanes 0-2 get the first box, 3-5
+// the second, 6-8 the third.
+static void bandBoxLanes(const uint16_t *boxes, int band, uint16_t *lanes) {
+    for (int c = 0; c < KERNEL_LANES; ++c) {
+        lanes[c] = c < 9 ? boxes[band * 3 + c / 3] : 0;
+    }
+}
+
+// Lane-wise countDigits on vectors of digit masks.
+__attribute__((target("sse4.1")))
+static inline void countLanes(__m128i &once, __m128i &twice, __m128i onceOther, __m128i twiceOther) {
+    twice = _mm_or_si128(twice, _mm_or_si128(twiceOther, _mm_and_si128(once, onceOther)));
+    once = _mm_or_si128(once, onceOther);
+}
+
+// Row counts from the two halves of a row: fold the upper eight lanes onto the
+// lower eight, then halve the width three times; lane 0 ends up with the row.
+__attribute__((target("sse4.1")))
+static inline void countRow(__m128i lo, __m128i hi, uint16_t &once, uint16_t &twice) {
+    __m128i o = _mm_or_si128(lo, hi);
+    __m128i t = _mm_and_si128(lo, hi);
+    countLanes(o, t, _mm_srli_si128(o, 8), _mm_srli_si128(t, 8));
+    countLanes(o, t, _mm_srli_si128(o, 4), _mm_srli_si128(t, 4));
+    countLanes(o, t, _mm_srli_si128(o, 2), _mm_srli_si128(t, 2));
+    once = static_cast<uint16_t>(_mm_extract_epi16(o, 0));
+    twice = static_cast<uint16_t>(_mm_extract_epi16(t, 0));
+}
+
+// Box counts from the per-lane counts of one band: fold lanes c+1 and c+2 onto
+// lane c, which leaves the three boxes in lanes 0, 3 and 6.
+__attribute__((target("sse4.1")))
+static inline void countBoxes(__m128i onceLo, __m128i onceHi, __m128i twiceLo, __m128i twiceHi, int band,
+                              uint16_t *once, uint16_t *twice) {
+    __m128i o = onceLo, t = twiceLo;
+    countLanes(o, t, _mm_alignr_epi8(onceHi, onceLo, 2), _mm_alignr_epi8(twiceHi, twiceLo, 2));
+    countLanes(o, t, _mm_alignr_epi8(onceHi, onceLo, 4), _mm_alignr_epi8(twiceHi, twiceLo, 4));
+    int first = 18 + band * 3;
+    once[first] = static_cast<uint16_t>(_mm_extract_epi16(o, 0));
+    once[first + 1] = static_cast<uint16_t>(_mm_extract_epi16(o, 3));
+    once[first + 2] = static_cast<uint16_t>(_mm_extract_epi16(o, 6));
+    twice[first] = static_cast<uint16_t>(_mm_extract_epi16(t, 0));
+    twice[first + 1] = static_cast<uint16_t>(_mm_extract_epi16(t, 3));
+    twice[first + 2] = static_cast<uint16_t>(_mm_extract_epi16(t, 6));
+}
+
+__attribute__((target("sse4.1")))
+static void storeColumns(__m128i onceLo, __m128i onceHi, __m128i twiceLo, __m128i twiceHi,
+                         uint16_t *once, uint16_t *twice) {
+    alignas(16) uint16_t lanes[4][8];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes[0]), onceLo);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes[1]), onceHi);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes[2]), twiceLo);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes[3]), twiceHi);
+    for (int c = 0; c < 9; ++c) {
+        once[9 + c] = c < 8 ? lanes[0][c] : lanes[1][0];
+        twice[9 + c] = c < 8 ? lanes[2][c] : lanes[3][0];
+    }
+}
+
+__attribute__((target("sse4.1")))
+static bool eliminateSse4(uint16_t *cells, const uint16_t *rows, const uint16_t *cols, const uint16_t *boxes,
+                          KernelSingles &singles) {
+    const __m128i placedBit = _mm_set1_epi16(static_cast<short>(KERNEL_PLACED));
+    const __m128i digitBits = _mm_set1_epi16(KERNEL_DIGITS);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colsLo = _mm_setr_epi16(cols[0], cols[1], cols[2], cols[3], cols[4], cols[5], cols[6], cols[7]);
+    const __m128i colsHi = _mm_setr_epi16(cols[8], 0, 0, 0, 0, 0, 0, 0);
+    uint16_t once[27], twice[27];
+    __m128i colOnce[2] = {zero, zero}, colTwice[2] = {zero, zero};
+
+    for (int band = 0; band < 3; ++band) {
+        alignas(16) uint16_t boxLanes[KERNEL_LANES];
+        bandBoxLanes(boxes, band, boxLanes);
+        __m128i boxLo = _mm_load_si128(reinterpret_cast<const __m128i *>(boxLanes));
+        __m128i boxHi = _mm_load_si128(reinterpret_cast<const __m128i *>(boxLanes + 8));
+        __m128i bandOnce[2] = {zero, zero}, bandTwice[2] = {zero, zero};
+
+        for (int r = band * 3; r < band * 3 + 3; ++r) {
+            __m128i *row = reinterpret_cast<__m128i *>(cells + r * KERNEL_LANES);
+            __m128i rowMask = _mm_set1_epi16(static_cast<short>(rows[r]));
+            __m128i halves[2] = {_mm_load_si128(row), _mm_load_si128(row + 1)};
+            __m128i used[2] = {_mm_or_si128(rowMask, _mm_or_si128(colsLo, boxLo)),
+                               _mm_or_si128(rowMask, _mm_or_si128(colsHi, boxHi))};
+            __m128i nakedLanes[2], digits[2];
+
+            for (int h = 0; h < 2; ++h) {
+                __m128i placed = _mm_cmpeq_epi16(_mm_and_si128(halves[h], placedBit), placedBit);
+                __m128i reduced = _mm_andnot_si128(used[h], halves[h]);
+                halves[h] = _mm_blendv_epi8(reduced, halves[h], placed);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(halves[h], zero))) {
+                    return false;
+                }
+                __m128i lowBitCleared = _mm_and_si128(halves[h], _mm_sub_epi16(halves[h], one));
+                nakedLanes[h] = _mm_andnot_si128(placed, _mm_cmpeq_epi16(lowBitCleared, zero));
+
+                digits[h] = _mm_and_si128(halves[h], digitBits);
+                countLanes(colOnce[h], colTwice[h], digits[h], zero);
+                countLanes(bandOnce[h], bandTwice[h], digits[h], zero);
+            }
+            _mm_store_si128(row, halves[0]);
+            _mm_store_si128(row + 1, halves[1]);
+            singles.naked[r] = static_cast<uint16_t>(_mm_movemask_epi8(_mm_packs_epi16(nakedLanes[0], nakedLanes[1])));
+            countRow(digits[0], digits[1], once[r], twice[r]);
+        }
+        countBoxes(bandOnce[0], bandOnce[1], bandTwice[0], bandTwice[1], band, once, twice);
+    }
+    storeColumns(colOnce[0], colOnce[1], colTwice[0], colTwice[1], once, twice);
+    return collectHidden(once, twice, rows, cols, boxes, singles);
+}
+
+__attribute__((target("avx2")))
+static inline void countLanes(__m256i &once, __m256i &twice, __m256i other) {
+    twice = _mm256_or_si256(twice, _mm256_and_si256(once, other));
+    once = _mm256_or_si256(once, other);
+}
+
+__attribute__((target("avx2")))
+static bool eliminateAvx2(uint16_t *cells, const uint16_t *rows, const uint16_t *cols, const uint16_t *boxes,
+                          KernelSingles &singles) {
+    const __m256i placedBit = _mm256_set1_epi16(static_cast<short>(KERNEL_PLACED));
+    const __m256i digitBits = _mm256_set1_epi16(KERNEL_DIGITS);
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    alignas(32) uint16_t colLanes[KERNEL_LANES] = {cols[0], cols[1], cols[2], cols[3], cols[4], cols[5], cols[6],
+                                                   cols[7], cols[8]};
+    const __m256i colMask = _mm256_load_si256(reinterpret_cast<const __m256i *>(colLanes));
+    uint16_t once[27], twice[27];
+    __m256i colOnce = zero, colTwice = zero;
+
+    for (int band = 0; band < 3; ++band) {
+        alignas(32) uint16_t boxLanes[KERNEL_LANES];
+        bandBoxLanes(boxes, band, boxLanes);
+        __m256i bandMask = _mm256_or_si256(colMask, _mm256_load_si256(reinterpret_cast<const __m256i *>(boxLanes)));
+        __m256i bandOnce = zero, bandTwice = zero;
+
+        for (int r = band * 3; r < band * 3 + 3; ++r) {
+            __m256i *row = reinterpret_cast<__m256i *>(cells + r * KERNEL_LANES);
+            __m256i lanes = _mm256_load_si256(row);
+            __m256i used = _mm256_or_si256(bandMask, _mm256_set1_epi16(static_cast<short>(rows[r])));
+
+            __m256i placed = _mm256_cmpeq_epi16(_mm256_and_si256(lanes, placedBit), placedBit);
+            lanes = _mm256_blendv_epi8(_mm256_andnot_si256(used, lanes), lanes, placed);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(lanes, zero))) {
+                return false;
+            }
+            _mm256_store_si256(row, lanes);
+
+            __m256i lowBitCleared = _mm256_and_si256(lanes, _mm256_sub_epi16(lanes, one));
+            __m256i nakedLanes = _mm256_andnot_si256(placed, _mm256_cmpeq_epi16(lowBitCleared, zero));
+            // packs works per 128-bit half: bytes 0-7 hold lanes 0-7, bytes 16-23 lanes 8-15.
+            unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_packs_epi16(nakedLanes, zero)));
+            singles.naked[r] = static_cast<uint16_t>((bits & 0xFF) | ((bits >> 8) & 0xFF00));
+
+            __m256i digits = _mm256_and_si256(lanes, digitBits);
+            countLanes(colOnce, colTwice, digits);
+            countLanes(bandOnce, bandTwice, digits);
+            countRow(_mm256_castsi256_si128(digits), _mm256_extracti128_si256(digits, 1), once[r], twice[r]);
+        }
+        countBoxes(_mm256_castsi256_si128(bandOnce), _mm256_extracti128_si256(bandOnce, 1),
+                   _mm256_castsi256_si128(bandTwice), _mm256_extracti128_si256(bandTwice, 1), band, once, twice);
+    }
+    storeColumns(_mm256_castsi256_si128(colOnce), _mm256_extracti128_si256(colOnce, 1),
+                 _mm256_castsi256_si128(colTwice), _mm256_extracti128_si256(colTwice, 1), once, twice);
+    return collectHidden(once, twice, rows, cols, boxes, singles);
+}
+
+#endif
+
+EliminateKernel selectEliminateKernel(KernelKind kind) {
+#ifdef SUDOKU_KERNEL_X86
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool sse4 = __builtin_cpu_supports("sse4.1");
+    if ((kind == KERNEL_AUTO || kind == KERNEL_AVX2) && avx2) {
+        return eliminateAvx2;
+    }
+    if ((kind == KERNEL_AUTO || kind == KERNEL_SSE4) && sse4) {
+        return eliminateSse4;
+    }
+#endif
+    return eliminateScalar;
+}
+
+const char *eliminateKernelName(EliminateKernel kernel) {
+#ifdef SUDOKU_KERNEL_X86
+    if (kernel == eliminateAvx2) {
+        return "avx2";
+    }
+    if (kernel == eliminateSse4) {
+        return "sse4";
+    }
+#endif
+    return "scalar";
+}
@@ -0,0 +1,40 @@
+#ifndef AILAB2_SUDOKUKERNEL_H
+#define AILAB2_SUDOKUKERNEL_H
+
+#include <cstdint>
+
+// Candidate elimination kernel used by SudokuEngine. The grid is stored as 9 rows
+// of 16 lanes of 16-bit candidate masks (lanes 9..15 are padding), so one row is
+// exactly one AVX2 register or two SSE registers. A placed cell keeps its digit
+// bit plus KERNEL_PLACED; padding lanes hold KERNEL_PLACED alone.
+
+const int KERNEL_LANES = 16;
+const uint16_t KERNEL_PLACED = 0x8000;
+
+// What a kernel pass found. Units are numbered as in SudokuEngine: rows 0-8,
+// columns 9-17, boxes 18-26.
+struct KernelSingles {
+    uint16_t naked[9];    // bit c of naked[r]: open cell (r, c) has one candidate left
+    uint16_t hidden[27];  // digits not yet placed that fit exactly one cell of the unit
+};
+
+// Removes every digit already placed in a cell's row, column or box from each
+// open cell, then collects naked and hidden singles from the result. Returns
+// false if an open cell runs out of candidates or a unit loses a digit entirely.
+using EliminateKernel = bool (*)(uint16_t *cells, const uint16_t *rows, const uint16_t *cols,
+                                 const uint16_t *boxes, KernelSingles &singles);
+
+enum KernelKind {
+    KERNEL_AUTO,
+    KERNEL_SCALAR,
+    KERNEL_SSE4,
+    KERNEL_AVX2,
+};
+
+// The best kernel the CPU supports for KERNEL_AUTO; otherwise the requested one,
+// falling back to scalar if the CPU (or compiler) cannot run it.
+EliminateKernel selectEliminateKernel(KernelKind kind = KERNEL_AUTO);
+
+const char *eliminateKernelName(EliminateKernel kernel);
+
+#endif //AILAB2_SUDOKUKERNEL_H
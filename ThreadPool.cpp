@@ -0,0 +1,69 @@
+#include "ThreadPool.h"
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int threads) : threads(threads < 1 ? 1 : threads) {
+    for (int i = 0; i < this->threads; ++i) {
+        queues.emplace_back(new TaskQueue());
+    }
+}
+
+int WorkStealingPool::size() const {
+    return threads;
+}
+
+bool WorkStealingPool::popLocal(int worker, size_t &task) {
+    TaskQueue &queue = *queues[worker];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+// Victims are tried round-robin starting after the thief, so thieves spread out.
+bool WorkStealingPool::steal(int worker, size_t &task) {
+    for (int offset = 1; offset < threads; ++offset) {
+        TaskQueue &victim = *queues[(worker + offset) % threads];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tasks are only ever removed once queued, so a worker that finds every deque
+// empty can stop.
+void WorkStealingPool::work(int worker, const function<void(int, size_t)> &task) {
+    size_t index;
+    while (popLocal(worker, index) || steal(worker, index)) {
+        task(worker, index);
+    }
+}
+
+void WorkStealingPool::run(size_t count, const function<void(int, size_t)> &task) {
+    for (int worker = 0; worker < threads; ++worker) {
+        size_t begin = count * worker / threads, end = count * (worker + 1) / threads;
+        for (size_t index = begin; index < end; ++index) {
+            queues[worker]->tasks.push_back(index);
+        }
+    }
+
+    vector<thread> helpers;
+    for (int worker = 1; worker < threads; ++worker) {
+        helpers.emplace_back(&WorkStealingPool::work, this, worker, cref(task));
+    }
+    work(0, task);
+    for (thread &helper: helpers) {
+        helper.join();
+    }
+}
+
+int defaultThreadCount() {
+    unsigned count = thread::hardware_concurrency();
+    return count ? static_cast<int>(count) : 1;
+}
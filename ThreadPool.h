@@ -0,0 +1,46 @@
+#ifndef AILAB2_THREADPOOL_H
+#define AILAB2_THREADPOOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Runs numbered tasks on a fixed number of threads. Each worker starts with a
+// contiguous share of the tasks in its own deque and takes them from the front;
+// once its deque is empty it steals from the back of another worker's, so a
+// worker stuck on slow tasks gives the rest of its share away.
+class WorkStealingPool {
+private:
+    struct TaskQueue {
+        mutex lock;
+        deque<size_t> tasks;
+    };
+
+    int threads;
+    vector<unique_ptr<TaskQueue>> queues;
+
+    bool popLocal(int worker, size_t &task);
+    bool steal(int worker, size_t &task);
+    void work(int worker, const function<void(int, size_t)> &task);
+
+public:
+    explicit WorkStealingPool(int threads);
+
+    int size() const;
+
+    // Runs task(worker, index) for every index in [0, count) and returns once all
+    // of them have finished. worker is in [0, size()) and identifies the thread,
+    // so callers can keep per-thread state in a vector.
+    void run(size_t count, const function<void(int, size_t)> &task);
+};
+
+// Number of threads to use when none is requested: the hardware concurrency,
+// or 1 if it is unknown.
+int defaultThreadCount();
+
+#endif //AILAB2_THREADPOOL_H
@@ -0,0 +1,82 @@
+#include "VariableTable.h"
+#include <cctype>
+
+VariableTable::VariableTable() : names(1) {
+}
+
+int VariableTable::intern(const string &name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(names.size());
+    ids.emplace(name, id);
+    names.push_back(name);
+    return id;
+}
+
+int VariableTable::find(const string &name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? 0 : it->second;
+}
+
+const string &VariableTable::name(int id) const {
+    return names[id];
+}
+
+int VariableTable::size() const {
+    return static_cast<int>(names.size()) - 1;
+}
+
+Literal VariableTable::internLiteral(const string &literal) {
+    if (literal[0] == '!') {
+        return -intern(literal.substr(1));
+    }
+    return intern(literal);
+}
+
+IntClause VariableTable::internClause(const string &clause) {
+    IntClause result;
+    string literal;
+    size_t pos = 0;
+    while (pos < clause.size()) {
+        while (pos < clause.size() && isspace(static_cast<unsigned char>(clause[pos]))) {
+            ++pos;
+        }
+        size_t end = pos;
+        while (end < clause.size() && !isspace(static_cast<unsigned char>(clause[end]))) {
+            ++end;
+        }
+        if (end > pos) {
+            literal.assign(clause, pos, end - pos);
+            result.push_back(internLiteral(literal));
+        }
+        pos = end;
+    }
+    return result;
+}
+
+IntFormula VariableTable::internFormula(const Formula &formula) {
+    IntFormula result;
+    result.reserve(formula.size());
+    for (const Clause &clause: formula) {
+        IntClause intClause;
+        intClause.reserve(clause.size());
+        for (const string &literal: clause) {
+            intClause.push_back(internLiteral(literal));
+        }
+        result.push_back(intClause);
+    }
+    return result;
+}
+
+// Only assigned variables are reported, like the map the string dpll() used to build.
+Assignment VariableTable::toAssignment(const Model &model) const {
+    Assignment assignment;
+    for (int var = 1; var < static_cast<int>(model.size()) && var <= size(); ++var) {
+        if (model[var] != VAL_UNASSIGNED) {
+            assignment[names[var]] = model[var] == VAL_TRUE;
+        }
+    }
+    return assignment;
+}
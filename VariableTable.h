@@ -0,0 +1,36 @@
+#ifndef AILAB2_VARIABLETABLE_H
+#define AILAB2_VARIABLETABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "DPLL.h"
+
+using namespace std;
+
+// Maps variable names such as "n5_r3_c7" to dense ids 1..size() so the solver
+// only ever sees signed integer literals (+id / -id). Names are interned once
+// when the formula is loaded and only looked up again when printing results.
+class VariableTable {
+public:
+    VariableTable();
+
+    int intern(const string &name);
+    int find(const string &name) const;
+    const string &name(int id) const;
+    int size() const;
+
+    Literal internLiteral(const string &literal);
+    // A clause as CNFConverter writes it: literals separated by whitespace.
+    IntClause internClause(const string &clause);
+    IntFormula internFormula(const Formula &formula);
+
+    Assignment toAssignment(const Model &model) const;
+
+private:
+    unordered_map<string, int> ids;
+    vector<string> names;  // names[0] is unused, ids start at 1
+};
+
+
+#endif //AILAB2_VARIABLETABLE_H
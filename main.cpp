@@ -1,13 +1,25 @@
 //
 // Created by yitong on 2023/10/25.
 //
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include "SudokuBoard.h"
 #include "DPLL.h"
+#include "VariableTable.h"
+#include "SudokuEncoder.h"
+#include "SudokuEngine.h"
+#include "BatchSolver.h"
+#include "ThreadPool.h"
+#include "Portfolio.h"
+#include "CubeAndConquer.h"
+#include "Dimacs.h"
+#include "InputFile.h"
+#include "Preprocessor.h"
 #include <vector>
 #include <string>
 #include"CNFConverter.h"
+#include "ClausePipeline.h"
 
 using namespace std;
 
@@ -15,24 +27,26 @@ string assign(int num, int row, int col) {
     return "n" + to_string(num) + "_r" + to_string(row) + "_c" + to_string(col);
 }
 
-vector<string> sudokuConstraints(const SudokuBoard &board) {
+template <int BoxSize>
+vector<string> sudokuConstraints(const SudokuGrid<BoxSize> &board) {
+    const int side = SudokuGrid<BoxSize>::SIDE;
     vector<string> clauses;
 
-    for (int row = 1; row <= 9; ++row) {
-        for (int col = 1; col <= 9; ++col) {
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
             // 1) At least one digit in a box
             string clause1 = "";
-            for (int num = 1; num <= 9; ++num) {
+            for (int num = 1; num <= side; ++num) {
                 clause1 += assign(num, row, col) + " v ";
             }
             clause1.pop_back(); // remove the last space
             clause1.pop_back(); // remove the last 'v'
             clauses.push_back(clause1);
 
-            for (int num = 1; num <= 9; ++num) {
+            for (int num = 1; num <= side; ++num) {
                 // 2) Unique row
                 string clause2 = assign(num, row, col) + " => !(";
-                for (int other_col = 1; other_col <= 9; ++other_col) {
+                for (int other_col = 1; other_col <= side; ++other_col) {
                     if (other_col != col) {
                         clause2 += assign(num, row, other_col) + " v ";
                     }
@@ -44,7 +58,7 @@ vector<string> sudokuConstraints(const SudokuBoard &board) {
 
                 // 3) Unique column
                 string clause3 = assign(num, row, col) + " => !(";
-                for (int other_row = 1; other_row <= 9; ++other_row) {
+                for (int other_row = 1; other_row <= side; ++other_row) {
                     if (other_row != row) {
                         clause3 += assign(num, other_row, col) + " v ";
                     }
@@ -54,12 +68,12 @@ vector<string> sudokuConstraints(const SudokuBoard &board) {
                 clause3 += ")";
                 clauses.push_back(clause3);
 
-                // 4) Unique 3x3
+                // 4) Unique box
                 string clause4 = assign(num, row, col) + " => !(";
-                int startRow = (row - 1) / 3 * 3 + 1;
-                int startCol = (col - 1) / 3 * 3 + 1;
-                for (int r = startRow; r < startRow + 3; ++r) {
-                    for (int c = startCol; c < startCol + 3; ++c) {
+                int startRow = (row - 1) / BoxSize * BoxSize + 1;
+                int startCol = (col - 1) / BoxSize * BoxSize + 1;
+                for (int r = startRow; r < startRow + BoxSize; ++r) {
+                    for (int c = startCol; c < startCol + BoxSize; ++c) {
                         if (r != row || c != col) {
                             clause4 += assign(num, r, c) + " v ";
                         }
@@ -74,8 +88,8 @@ vector<string> sudokuConstraints(const SudokuBoard &board) {
     }
 
     // 5) Initial board
-    for (int row = 1; row <= 9; ++row) {
-        for (int col = 1; col <= 9; ++col) {
+    for (int row = 1; row <= side; ++row) {
+        for (int col = 1; col <= side; ++col) {
             int cellValue = board.getCell(row, col); // Assuming SudokuBoard has getCell method
             if (cellValue) {
                 clauses.push_back(assign(cellValue, row, col));
@@ -87,39 +101,6 @@ vector<string> sudokuConstraints(const SudokuBoard &board) {
 }
 
 
-vector<vector<string>> convertToDPLLInput(const vector<string> &clauses) {
-    vector<vector<string>> dpllInput;
-
-    for (const auto &clauseStr: clauses) {
-        vector<string> clause;
-
-        size_t pos = 0;  // 当前位置
-        while (pos < clauseStr.size()) {
-            // 跳过前导空格
-            while (pos < clauseStr.size() && isspace(clauseStr[pos])) {
-                ++pos;
-            }
-
-            // 找到单词的结束位置
-            size_t end = pos;
-            while (end < clauseStr.size() && !isspace(clauseStr[end])) {
-                ++end;
-            }
-
-            // 如果找到了单词，添加到子句中
-            if (end > pos) {
-                clause.push_back(clauseStr.substr(pos, end - pos));
-            }
-
-            pos = end;
-        }
-
-        dpllInput.push_back(clause);
-    }
-
-    return dpllInput;
-}
-
 void writeAssignmentsToFile(const map<string, bool> &assignments, const string &filename) {
     ofstream outFile(filename);
     if (!outFile.is_open()) {
@@ -129,6 +110,9 @@ void writeAssignmentsToFile(const map<string, bool> &assignments, const string &
 
     for (const auto &pair: assignments) {
         string literal = pair.first;
+        if (CNFConverter::isAuxiliaryVariable(literal)) {
+            continue;
+        }
         bool value = pair.second;
 
         // 检查文字是否以!开头，并相应地调整值
@@ -148,42 +132,270 @@ void writeAssignmentsToFile(const map<string, bool> &assignments, const string &
     outFile.close();
 }
 
-bool isValidSudokuInput(const std::vector<std::string> &inputs) {
-    for (const std::string &input : inputs) {
-
-        int row = input[0] - '0';
-        int col = input[1] - '0';
-        int val = input[3] - '0';
-
-        if (input[2] != '=' || row < 1 || row > 9 || col < 1 || col > 9 || val < 1 || val > 9) {
+// Reads one given: "rc=v" with single digits (9x9 only) or "r,c=v" in decimal.
+// row and col come back 0-based.
+bool parseSudokuInput(const string &input, int side, int &row, int &col, int &val) {
+    size_t comma = input.find(',');
+    size_t equals = input.find('=');
+    if (equals == string::npos) {
+        return false;
+    }
+    if (comma == string::npos) {
+        if (side != 9 || input.size() != 4 || equals != 2 || !isdigit(input[0]) || !isdigit(input[1]) ||
+            !isdigit(input[3])) {
+            return false;
+        }
+        row = input[0] - '0';
+        col = input[1] - '0';
+        val = input[3] - '0';
+    } else {
+        if (comma > equals || input.find_first_not_of("0123456789,=") != string::npos || comma == 0 ||
+            equals == comma + 1 || equals + 1 == input.size() || input.find(',', comma + 1) != string::npos ||
+            input.find('=', equals + 1) != string::npos) {
             return false;
         }
+        row = atoi(input.substr(0, comma).c_str());
+        col = atoi(input.substr(comma + 1, equals - comma - 1).c_str());
+        val = atoi(input.substr(equals + 1).c_str());
     }
+    if (row < 1 || row > side || col < 1 || col > side || val < 1 || val > side) {
+        return false;
+    }
+    row--;
+    col--;
     return true;
 }
 
-// Function to write CNF clauses to a file
-bool writeCnfToFile(const std::vector<std::string> &cnfClauses, const std::string &filename) {
-    std::ofstream outFile(filename);  // Attempt to open the file
+struct SudokuModeOptions {
+    bool verbose = false;
+    bool stats = false;
+    bool reduced = false;
+    bool native = false;
+    bool check = false;
+    bool tseitin = false;
+    bool preprocess = false;  // -v only
+    int threads = 1;  // CNFConverter threads (-v)
+    KernelKind kernel = KERNEL_AUTO;
+    SolverOptions solver;
+};
+
+bool solveNative(const SudokuBoard &board, SudokuBoard &solution, KernelKind kind, bool stats) {
+    SudokuEngine engine(kind);
+    bool solved = engine.solve(board, solution);
+    if (stats) {
+        cerr << "kernel: " << engine.kernelName() << endl;
+        cerr << "guesses: " << engine.guessCount() << endl;
+    }
+    return solved;
+}
 
-    if (!outFile.is_open()) {  // Check if the file was opened successfully
-        std::cerr << "Unable to open file " << filename << " for writing." << std::endl;
-        return false;  // Return false if the file couldn't be opened
+// The native engine is 9x9 only; main() rejects --engine=native and -check for
+// bigger boards, so this is never reached.
+template <int BoxSize>
+bool solveNative(const SudokuGrid<BoxSize> &, SudokuGrid<BoxSize> &, KernelKind, bool) {
+    return false;
+}
+
+// Solves the givens from the command line and prints the board. Returns the
+// exit code.
+template <int BoxSize>
+int solveSudokuMode(const vector<string> &inputs, const SudokuModeOptions &mode) {
+    const int side = SudokuGrid<BoxSize>::SIDE;
+    SudokuGrid<BoxSize> board;
+
+    // Reading from command line and populating board
+    for (const auto &input: inputs) {
+        int row, col, val;
+        if (!parseSudokuInput(input, side, row, col, val)) {
+            std::cerr << "Invalid input format or values out of range." << std::endl;
+            return 1;
+        }
+        board.setCell(row, col, val);
     }
 
-    for (const std::string &clause: cnfClauses) {  // Iterate through the CNF clauses
-        outFile << clause << std::endl;  // Write each clause followed by a newline
+    SudokuGrid<BoxSize> solution;
+    bool solved;
+    SolverStats stats;
+    SolverOptions solverOptions = mode.solver;
+    if (mode.native) {
+        solved = solveNative(board, solution, mode.kernel, mode.stats);
+    } else if (mode.verbose) {
+        // Debug path: go through the string constraints and CNFConverter so the
+        // CNF dump shows exactly what the converter produces.
+        // Names are interned in sudokuVariable() order so both encodings share ids.
+        VariableTable variables;
+        for (int r = 1; r <= side; ++r) {
+            for (int c = 1; c <= side; ++c) {
+                for (int n = 1; n <= side; ++n) {
+                    variables.intern(assign(n, r, c));
+                }
+            }
+        }
+
+        vector<string> clauses = sudokuConstraints(board);
+
+        CNFConverter converter(mode.tseitin ? CNF_TSEITIN : CNF_DISTRIBUTE, mode.threads);
+
+        //verboseMode to write cnfforsudoku to file
+        ofstream cnfFile("cnfForSudoku1.txt");
+        if (!cnfFile.is_open()) {
+            std::cerr << "Unable to open file cnfForSudoku1.txt for writing." << std::endl;
+            return 1;
+        }
+        // The converter runs on its own thread while the clauses are written out
+        // and interned here.
+        IntFormula inputForDPLL;
+        streamClauses([&](const CNFConverter::ClauseSink &sink) { converter.convert(clauses, sink); },
+                      variables, inputForDPLL, [&cnfFile](const string &clause) { cnfFile << clause << '\n'; });
+        cnfFile.close();
+
+        // The same clauses as DIMACS, for external solvers.
+        ofstream dimacsFile("cnfForSudoku1.cnf");
+        if (!dimacsFile.is_open()) {
+            std::cerr << "Unable to open file cnfForSudoku1.cnf for writing." << std::endl;
+            return 1;
+        }
+        dimacsFile << "c Sudoku " << side << "x" << side << ": variable ((row-1)*" << side << " + col-1)*" << side
+                   << " + digit\n";
+        writeDimacs(inputForDPLL, variables.size(), dimacsFile);
+        dimacsFile.close();
+        solverOptions.mrvGroups = sudokuCells<BoxSize>();
+
+        Preprocessor preprocessor(variables.size());
+        bool satisfiable = true;
+        if (mode.preprocess) {
+            satisfiable = preprocessor.simplify(inputForDPLL);
+            printPreprocessStats(preprocessor.stats(), cerr);
+        }
+        Model model = satisfiable ? dpll(inputForDPLL, variables.size(), solverOptions, &stats) : Model();
+        preprocessor.extendModel(model);
+        writeAssignmentsToFile(variables.toAssignment(model), "dp_output.txt");
+        solved = !model.empty();
+        if (solved) {
+            solution = decodeSudoku(model, board);
+        }
+    } else if (mode.reduced) {
+        solved = solveSudokuSat(board, true, solverOptions, solution, &stats);
+    } else {
+        IncrementalSudokuSolver<BoxSize> satSolver(solverOptions);
+        solved = satSolver.solve(board, solution);
+        stats = satSolver.stats();
+        if (!solved) {
+            // The givens that already contradict each other, in the input syntax,
+            // when the search could single them out.
+            const SudokuGrid<BoxSize> &conflicting = satSolver.conflictingGivens();
+            string listed;
+            for (int r = 1; r <= side; ++r) {
+                for (int c = 1; c <= side; ++c) {
+                    if (conflicting.getCell(r, c)) {
+                        listed += " " + to_string(r) + "," + to_string(c) + "=" +
+                                  to_string(conflicting.getCell(r, c));
+                    }
+                }
+            }
+            if (!listed.empty()) {
+                cerr << "Conflicting givens:" << listed << endl;
+            }
+        }
+    }
+    if (mode.stats && !mode.native) {
+        printStats(stats, cerr);
+    }
+
+    if (mode.check) {
+        // Solve again with the other engine and make sure both answers hold up.
+        SudokuGrid<BoxSize> other;
+        bool otherSolved;
+        if (mode.native) {
+            otherSolved = solveSudokuSat(board, mode.reduced, solverOptions, other);
+        } else {
+            otherSolved = solveNative(board, other, mode.kernel, false);
+        }
+        if (solved != otherSolved ||
+            (solved && (!isValidSolution(solution, board) || !isValidSolution(other, board)))) {
+            cerr << "Check failed: the native and SAT engines disagree." << endl;
+            return 1;
+        }
+        cerr << "Check passed: the native and SAT engines agree." << endl;
     }
 
-    outFile.close();  // Close the file stream
-    return true;  // Return true if everything was written successfully
+    if (!solved) {
+        cout << "No solution found!\n";
+    } else {
+        cout << "Sudoku Solution:\n";
+        // Extract solution from the assignments and display
+        solution.printBoard();
+    }
+    return 0;
+}
+
+struct FormulaModeOptions {
+    bool stats = false;
+    int threads = 1;
+    int maxCubes = 0;
+    int portfolioSize = 1;
+    bool shareClauses = false;
+    bool preprocess = false;
+    SolverOptions solver;
+};
+
+// Solves a -bnf or -dimacs formula with cube and conquer, a portfolio or a
+// single solver, as requested, after preprocessing it if asked to.
+Model solveFormula(IntFormula formula, int numVars, const FormulaModeOptions &mode) {
+    SolverStats stats;
+    Model model;
+    Preprocessor preprocessor(numVars);
+    if (mode.preprocess) {
+        bool satisfiable = preprocessor.simplify(formula);
+        printPreprocessStats(preprocessor.stats(), cerr);
+        if (!satisfiable) {
+            return model;
+        }
+    }
+    if (mode.maxCubes > 0) {
+        size_t cubeCount;
+        model = solveCubeAndConquer(formula, numVars, mode.solver, mode.threads, mode.maxCubes, &stats, &cubeCount);
+        if (mode.stats) {
+            cerr << "cubes: " << cubeCount << endl;
+        }
+    } else if (mode.portfolioSize > 1) {
+        int winner;
+        model = solvePortfolio(formula, numVars, portfolioConfigs(mode.solver, mode.portfolioSize), mode.shareClauses,
+                               &winner, &stats);
+        if (mode.stats) {
+            cerr << "portfolio winner: " << winner << endl;
+        }
+    } else {
+        model = dpll(formula, numVars, mode.solver, &stats);
+    }
+    if (mode.stats) {
+        printStats(stats, cerr);
+    }
+    preprocessor.extendModel(model);
+    return model;
 }
 
 int main(int argc, char *argv[]) {
     bool verboseMode = false;
+    bool statsMode = false;
+    bool reducedEncoding = false;
+    bool nativeEngine = false;
+    bool checkMode = false;
+    bool tseitinMode = false;
+    bool preprocessMode = false;
+    KernelKind kernelKind = KERNEL_AUTO;
     bool sudokuMode = true;  // Default mode is Sudoku
     string filename;
     bool bnfMode = false;
+    bool dimacsMode = false;
+    bool batchMode = false;
+    bool benchMode = false;
+    int threads = defaultThreadCount();
+    int portfolioSize = 1;
+    bool shareClauses = false;
+    int maxCubes = 0;
+    int boxSize = 3;
+    SolverOptions solverOptions;
     std::vector<std::string> sudokuInputs; // To store Sudoku inputs if provided
 
     // Parse command-line arguments
@@ -191,78 +403,184 @@ int main(int argc, char *argv[]) {
         string arg = argv[i];
         if (arg == "-v") {
             verboseMode = true;
+        } else if (arg == "-cdcl") {
+            solverOptions.mode = MODE_CDCL;
+        } else if (arg == "-stats") {
+            statsMode = true;
+        } else if (arg == "-reduced") {
+            reducedEncoding = true;
+        } else if (arg == "-check") {
+            checkMode = true;
+        } else if (arg.compare(0, 9, "--engine=") == 0) {
+            string name = arg.substr(9);
+            if (name == "native") {
+                nativeEngine = true;
+            } else if (name == "sat") {
+                nativeEngine = false;
+            } else {
+                std::cerr << "Unknown engine: " << name << " (expected native or sat)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "--kernel=") == 0) {
+            string name = arg.substr(9);
+            if (name == "auto") {
+                kernelKind = KERNEL_AUTO;
+            } else if (name == "avx2") {
+                kernelKind = KERNEL_AVX2;
+            } else if (name == "sse4") {
+                kernelKind = KERNEL_SSE4;
+            } else if (name == "scalar") {
+                kernelKind = KERNEL_SCALAR;
+            } else {
+                std::cerr << "Unknown kernel: " << name << " (expected auto, avx2, sse4 or scalar)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 11, "-heuristic=") == 0) {
+            string name = arg.substr(11);
+            if (name == "vsids") {
+                solverOptions.heuristic = HEURISTIC_VSIDS;
+            } else if (name == "mrv") {
+                solverOptions.heuristic = HEURISTIC_MRV;
+            } else if (name == "first") {
+                solverOptions.heuristic = HEURISTIC_FIRST;
+            } else {
+                std::cerr << "Unknown heuristic: " << name << " (expected vsids, mrv or first)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "-restart=") == 0) {
+            string name = arg.substr(9);
+            if (name == "glucose") {
+                solverOptions.restart = RESTART_GLUCOSE;
+            } else if (name == "luby") {
+                solverOptions.restart = RESTART_LUBY;
+            } else if (name == "none") {
+                solverOptions.restart = RESTART_NONE;
+            } else {
+                std::cerr << "Unknown restart policy: " << name << " (expected glucose, luby or none)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-pure") {
+            solverOptions.pureLiterals = true;
+        } else if (arg == "-probe") {
+            solverOptions.probing = true;
+        } else if (arg.compare(0, 7, "-probe=") == 0) {
+            solverOptions.probing = true;
+            solverOptions.probeLevels = atoi(arg.c_str() + 7);
+            if (solverOptions.probeLevels < 0) {
+                std::cerr << "-probe= expects a level count of 0 or more" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-batch" && i + 1 < argc) {
+            batchMode = true;
+            filename = argv[++i];
+        } else if (arg == "-bench") {
+            benchMode = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) {
+                std::cerr << "-j expects a positive thread count" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-portfolio" && i + 1 < argc) {
+            portfolioSize = atoi(argv[++i]);
+            if (portfolioSize < 1) {
+                std::cerr << "-portfolio expects a positive solver count" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-cubes" && i + 1 < argc) {
+            maxCubes = atoi(argv[++i]);
+            if (maxCubes < 1) {
+                std::cerr << "-cubes expects a positive cube count" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-box" && i + 1 < argc) {
+            boxSize = atoi(argv[++i]);
+            if (boxSize < 3 || boxSize > 5) {
+                std::cerr << "-box expects 3, 4 or 5" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-tseitin") {
+            tseitinMode = true;
+        } else if (arg == "-preprocess") {
+            preprocessMode = true;
+        } else if (arg == "-share") {
+            shareClauses = true;
+        } else if (arg == "-dimacs" && i + 1 < argc) {
+            sudokuMode = false;
+            dimacsMode = true;
+            filename = argv[++i];
         } else if (arg == "-bnf" && i + 1 < argc) {
             sudokuMode = false;
             bnfMode = true;
             filename = argv[++i];
-            i++; // Skip the next argument since it's the filename
         } else {
             // If not in BNF mode, treat it as Sudoku input
-            if (!bnfMode) {
+            if (!bnfMode && !dimacsMode) {
                 sudokuInputs.push_back(arg);
             } else {
-                std::cerr << "Unexpected argument after -bnf flag: " << arg << std::endl;
+                std::cerr << "Unexpected argument after -bnf or -dimacs flag: " << arg << std::endl;
                 return 1;
             }
         }
     }
 
+    if (boxSize != 3 && (nativeEngine || checkMode || batchMode)) {
+        std::cerr << "The native engine, -check and -batch only handle 9x9 boards." << std::endl;
+        return 1;
+    }
 
-    if (sudokuMode) {
-        if (!isValidSudokuInput(sudokuInputs)) {
-            std::cerr << "Invalid input format or values out of range." << std::endl;
-            return 1;
+    if (batchMode) {
+        BatchOptions batchOptions;
+        batchOptions.nativeEngine = nativeEngine;
+        batchOptions.reducedEncoding = reducedEncoding;
+        batchOptions.kernel = kernelKind;
+        batchOptions.solver = solverOptions;
+        batchOptions.threads = threads;
+        if (benchMode) {
+            return benchmarkBatch(filename, batchOptions, cout) ? 0 : 1;
         }
-        SudokuBoard board;
-
-        // Reading from command line and populating board
-        for (const auto &input: sudokuInputs) {
-            int row = input[0] - '1';
-            int col = input[1] - '1';
-            int val = input[3] - '0';
-            board.setCell(row, col, val);
-        }
-
-        vector<string> clauses = sudokuConstraints(board);
-
-        CNFConverter converter;
-        vector<string> cnfClauses = converter.convert(clauses);
-
-        if (verboseMode) { //verboseMode to write cnfforsudoku to file
-            // Call the function to write CNF clauses to a file
-            if (!writeCnfToFile(cnfClauses, "cnfForSudoku1.txt")) {
-                return 1;  // If writing to the file failed, return an error code
-            }
+        BatchSummary summary;
+        if (!solveBatch(filename, batchOptions, cout, summary)) {
+            return 1;
         }
+        printBatchSummary(summary, cerr);
+        return 0;
+    }
 
+    // Plain DPLL does not get through near-empty 16x16 and 25x25 boards in any
+    // reasonable time; clause learning solves them at once.
+    if (boxSize > 3) {
+        solverOptions.mode = MODE_CDCL;
+    }
 
-        vector<vector<string>> inputForDPLL = convertToDPLLInput(cnfClauses);
-
-
-        map<string, bool> initialAssignments;
-
-        map<string, bool> assignments = dpll(inputForDPLL, initialAssignments);
+    FormulaModeOptions formulaMode;
+    formulaMode.stats = statsMode;
+    formulaMode.threads = threads;
+    formulaMode.maxCubes = maxCubes;
+    formulaMode.portfolioSize = portfolioSize;
+    formulaMode.shareClauses = shareClauses;
+    formulaMode.preprocess = preprocessMode;
+    formulaMode.solver = solverOptions;
 
-        if (verboseMode) {
-            writeAssignmentsToFile(assignments, "dp_output.txt");
-        }
-        if (assignments.empty()) {
-            cout << "No solution found!\n";
-        } else {
-            cout << "Sudoku Solution:\n";
-            // Extract solution from the assignments and display
-            for (int r = 1; r <= 9; ++r) {
-                for (int c = 1; c <= 9; ++c) {
-                    for (int n = 1; n <= 9; ++n) {
-                        string var = "n" + to_string(n) + "_r" + to_string(r) + "_c" + to_string(c);
-                        if (assignments[var]) {
-                            cout << n << " ";
-                            break;
-                        }
-                    }
-                }
-                cout << "\n";
-            }
+    if (sudokuMode) {
+        SudokuModeOptions mode;
+        mode.verbose = verboseMode;
+        mode.stats = statsMode;
+        mode.reduced = reducedEncoding;
+        mode.native = nativeEngine;
+        mode.check = checkMode;
+        mode.tseitin = tseitinMode;
+        mode.preprocess = preprocessMode;
+        mode.threads = threads;
+        mode.kernel = kernelKind;
+        mode.solver = solverOptions;
+        switch (boxSize) {
+            case 4:
+                return solveSudokuMode<4>(sudokuInputs, mode);
+            case 5:
+                return solveSudokuMode<5>(sudokuInputs, mode);
+            default:
+                return solveSudokuMode<3>(sudokuInputs, mode);
         }
     } else if (bnfMode) {
         if (filename.empty()) {
@@ -270,38 +588,42 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cerr << "Error opening file: " << filename << endl;
+        InputFile file;
+        if (!file.open(filename)) {
             return 1;
         }
 
-        vector<string> bnfClauses;
-        string line;
-        while (getline(file, line)) {
-            bnfClauses.push_back(line);
-        }
-        file.close();
-
-        CNFConverter converter1;
-        vector<string> cnfClauses1 = converter1.convertBnf(bnfClauses);
-
+        // Parsing and conversion run on a second thread; the clauses are echoed
+        // (-v) and interned as they arrive instead of being collected first.
+        CNFConverter converter1(tseitinMode ? CNF_TSEITIN : CNF_DISTRIBUTE, threads);
+        VariableTable variables;
+        IntFormula inputForDPLL;
+        function<void(const string &)> echo;
         if (verboseMode) {
-            for (const string &clause: cnfClauses1) {
-                cout << clause << endl;
-            }
+            echo = [](const string &clause) { cout << clause << '\n'; };
         }
-        vector<vector<string>> inputForDPLL = convertToDPLLInput(cnfClauses1);
-
-
-        map<string, bool> initialAssignments;
-
-        map<string, bool> assignments = dpll(inputForDPLL, initialAssignments);
-        for (const auto &assignment: assignments) {
+        streamClauses([&](const CNFConverter::ClauseSink &sink) { converter1.convertBnf(file.data(), file.size(), sink); },
+                      variables, inputForDPLL, echo);
+        cout.flush();
+
+        Model model = solveFormula(std::move(inputForDPLL), variables.size(), formulaMode);
+        for (const auto &assignment: variables.toAssignment(model)) {
+            if (CNFConverter::isAuxiliaryVariable(assignment.first)) {
+                continue;
+            }
             cout << assignment.first << " = " << (assignment.second ? "true" : "false") << endl;
         }
         cout << "other elements are arbitrary,if exists" << endl;
 
+    } else if (dimacsMode) {
+        IntFormula formula;
+        int numVars;
+        if (!readDimacs(filename, formula, numVars)) {
+            return 1;
+        }
+        Model model = solveFormula(std::move(formula), numVars, formulaMode);
+        writeDimacsModel(model, numVars, cout);
+        return model.empty() ? 20 : 10;  // SAT competition exit codes
     }
     return 0;
 }
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "TestUtil.h"
+#include "BatchSolver.h"
+#include "SudokuEngine.h"
+
+static const char *const PUZZLES[] = {
+    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+    "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+    "12345678.........9...............................................................",
+    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..7",
+    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..7x",
+};
+
+// A file of many puzzles, with blank and CRLF lines, so that the work is split
+// into several chunks; expected gets one line per puzzle.
+static void writePuzzles(const char *path, vector<string> &expected, BatchSummary &counts) {
+    ofstream file(path, ios::binary);
+    SudokuEngine engine;
+    for (int i = 0; i < 1300; ++i) {
+        const char *line = PUZZLES[i % 5];
+        file << line << (i % 7 ? "\n" : "\r\n");
+        if (i % 11 == 0) {
+            file << "\n";
+        }
+        SudokuBoard givens, solution;
+        string output;
+        ++counts.puzzles;
+        if (!parsePuzzleLine(line, givens)) {
+            ++counts.malformed;
+        } else if (engine.solve(givens, solution)) {
+            appendPuzzleLine(solution, output);
+            ++counts.solved;
+        } else {
+            ++counts.unsolved;
+        }
+        expected.push_back(output.empty() ? string(81, '.') : output);
+    }
+}
+
+static void testBatch() {
+    const char *path = "BatchTest.tmp";
+    vector<string> expected;
+    BatchSummary counts;
+    writePuzzles(path, expected, counts);
+    CHECK(counts.malformed > 0 && counts.unsolved > 0);
+
+    for (int run = 0; run < 6; ++run) {
+        BatchOptions options;
+        options.nativeEngine = run < 2;
+        options.reducedEncoding = run == 3;
+        options.solver.mode = run == 4 ? MODE_CDCL : MODE_DPLL;
+        options.threads = run % 2 ? 4 : 1;
+        ostringstream out;
+        BatchSummary summary;
+        CHECK(solveBatch(path, options, out, summary));
+        CHECK(summary.puzzles == counts.puzzles);
+        CHECK(summary.solved == counts.solved);
+        CHECK(summary.unsolved == counts.unsolved);
+        CHECK(summary.malformed == counts.malformed);
+
+        istringstream lines(out.str());
+        string line;
+        size_t index = 0;
+        while (getline(lines, line)) {
+            CHECK(index < expected.size() && line == expected[index]);
+            ++index;
+        }
+        CHECK(index == expected.size());
+    }
+    remove(path);
+
+    ostringstream out;
+    BatchSummary summary;
+    CHECK(!solveBatch("BatchTest.missing", BatchOptions(), out, summary));
+}
+
+int main() {
+    testBatch();
+    return testResult("BatchTest");
+}
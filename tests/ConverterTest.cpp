@@ -0,0 +1,136 @@
+#include "TestUtil.h"
+#include "CNFConverter.h"
+#include "VariableTable.h"
+
+const int EXPR_VARS = 5;  // A..E
+
+// Random expression tree, kept alongside its text so the test can evaluate it.
+struct Expr {
+    char op;  // 'x' variable, '!', '^', 'v', '>' (=>), '=' (<=>)
+    int var;
+    int left, right;
+};
+
+static int randomExpr(mt19937 &rng, int depth, vector<Expr> &nodes) {
+    static const char OPS[] = {'!', '^', 'v', '>', '='};
+    Expr expr = {'x', static_cast<int>(rng() % EXPR_VARS), -1, -1};
+    if (depth > 0 && rng() % 4) {
+        expr.op = OPS[rng() % 5];
+        expr.left = randomExpr(rng, depth - 1, nodes);
+        if (expr.op != '!') {
+            expr.right = randomExpr(rng, depth - 1, nodes);
+        }
+    }
+    nodes.push_back(expr);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+// Binary operators are fully parenthesized except at the top, so precedence
+// only matters between '!' and its operand.
+static string exprText(const vector<Expr> &nodes, int index, bool top) {
+    const Expr &expr = nodes[index];
+    if (expr.op == 'x') {
+        return string(1, static_cast<char>('A' + expr.var));
+    }
+    if (expr.op == '!') {
+        return "!" + exprText(nodes, expr.left, false);
+    }
+    string op = expr.op == '>' ? "=>" : expr.op == '=' ? "<=>" : string(1, expr.op);
+    string text = exprText(nodes, expr.left, false) + " " + op + " " + exprText(nodes, expr.right, false);
+    return top ? text : "(" + text + ")";
+}
+
+static bool evaluate(const vector<Expr> &nodes, int index, unsigned bits) {
+    const Expr &expr = nodes[index];
+    bool left = expr.left >= 0 && evaluate(nodes, expr.left, bits);
+    bool right = expr.right >= 0 && evaluate(nodes, expr.right, bits);
+    switch (expr.op) {
+        case 'x':
+            return bits >> expr.var & 1;
+        case '!':
+            return !left;
+        case '^':
+            return left && right;
+        case 'v':
+            return left || right;
+        case '>':
+            return !left || right;
+        default:
+            return left == right;
+    }
+}
+
+// Every assignment of A..E must extend to a model of the clauses exactly when
+// it satisfies all expressions. Under CNF_DISTRIBUTE the clauses may not
+// mention anything but A..E.
+static void checkModels(const vector<string> &clauses, CNFMode mode, const vector<Expr> &nodes,
+                        const vector<int> &roots) {
+    VariableTable variables;
+    for (int var = 0; var < EXPR_VARS; ++var) {
+        variables.intern(string(1, static_cast<char>('A' + var)));
+    }
+    IntFormula formula;
+    for (const string &clause : clauses) {
+        formula.push_back(variables.internClause(clause));
+    }
+    for (int id = EXPR_VARS + 1; id <= variables.size(); ++id) {
+        CHECK(mode == CNF_TSEITIN && CNFConverter::isAuxiliaryVariable(variables.name(id)));
+    }
+    for (unsigned bits = 0; bits < 1u << EXPR_VARS; ++bits) {
+        bool expected = true;
+        for (int root : roots) {
+            expected = expected && evaluate(nodes, root, bits);
+        }
+        IntFormula fixed = formula;
+        for (int var = 1; var <= EXPR_VARS; ++var) {
+            fixed.push_back({bits >> (var - 1) & 1 ? var : -var});
+        }
+        CHECK(dpll(fixed, variables.size()).empty() != expected);
+    }
+}
+
+static void testConversion(CNFMode mode) {
+    mt19937 rng(11);
+    for (int iter = 0; iter < 400; ++iter) {
+        vector<Expr> nodes;
+        vector<int> roots;
+        vector<string> exprs;
+        string bnf;
+        for (int i = static_cast<int>(rng() % 4); i >= 0; --i) {
+            roots.push_back(randomExpr(rng, mode == CNF_DISTRIBUTE ? 3 : 5, nodes));
+            exprs.push_back(exprText(nodes, roots.back(), true));
+            bnf += exprs.back() + (rng() & 1 ? "\n" : "\r\n");
+        }
+
+        vector<string> clauses = CNFConverter(mode, 1).convert(exprs);
+        checkModels(clauses, mode, nodes, roots);
+
+        // Same clauses in the same order through every entry point and thread count.
+        CHECK(CNFConverter(mode, 3).convert(exprs) == clauses);
+        CHECK(CNFConverter(mode, 2).convertBnf(bnf.data(), bnf.size()) == clauses);
+        vector<string> streamed;
+        CNFConverter(mode, 4).convertBnf(bnf.data(), bnf.size(),
+                                         [&streamed](string &&clause) { streamed.push_back(clause); });
+        CHECK(streamed == clauses);
+    }
+}
+
+// A parity chain over 16 variables has 2^15 clauses in CNF_DISTRIBUTE; the
+// Tseitin encoding stays linear, and the same input through convertBnf()
+// must not fall back to anything else.
+static void testTseitinSize() {
+    string chain = "A";
+    for (char var = 'B'; var <= 'P'; ++var) {
+        chain = "(" + chain + " <=> " + var + ")";
+    }
+    vector<string> clauses = CNFConverter(CNF_TSEITIN, 1).convert({chain});
+    CHECK(!clauses.empty() && clauses.size() <= 4 * 15 + 1);
+    CHECK(CNFConverter(CNF_TSEITIN, 1).convertBnf(chain.data(), chain.size()) == clauses);
+}
+
+int main() {
+    testConversion(CNF_DISTRIBUTE);
+    testConversion(CNF_TSEITIN);
+    testTseitinSize();
+    return testResult("ConverterTest");
+}
@@ -0,0 +1,94 @@
+#include <sstream>
+#include "TestUtil.h"
+#include "Dimacs.h"
+
+static bool parse(const string &text, IntFormula &formula, int &numVars) {
+    return parseDimacs(text.data(), text.size(), formula, numVars);
+}
+
+static void testParse() {
+    IntFormula formula;
+    int numVars = 0;
+    CHECK(parse("c comment\np cnf 3 3\n1 -2 0\n-1\n 3\t0 2 0\n", formula, numVars));
+    CHECK(numVars == 3);
+    CHECK(formula == IntFormula({{1, -2}, {-1, 3}, {2}}));
+
+    // SATLIB files end with "%" and "0"; the last clause may lack its 0.
+    CHECK(parse("p cnf 2 2\r\n1 2 0\r\n-1 -2\r\n%\r\n0\r\n", formula, numVars));
+    CHECK(formula == IntFormula({{1, 2}, {-1, -2}}));
+    CHECK(parse("p cnf 2 1\n-1 2", formula, numVars));
+    CHECK(formula == IntFormula({{-1, 2}}));
+    CHECK(parse("p cnf 0 0\n", formula, numVars) && numVars == 0 && formula.empty());
+    CHECK(parse("p cnf 1 1\n0\n", formula, numVars) && formula == IntFormula({{}}));
+}
+
+static void testErrors() {
+    IntFormula formula;
+    int numVars = 0;
+    CHECK(!parse("", formula, numVars));
+    CHECK(!parse("1 2 0\n", formula, numVars));
+    CHECK(!parse("1 2 0\np cnf 2 1\n", formula, numVars));
+    CHECK(!parse("p cnf 2 1\n1 3 0\n", formula, numVars));
+    CHECK(!parse("p cnf 2 1\n1 -3 0\n", formula, numVars));
+    CHECK(!parse("p cnf 2 1\n1 x 0\n", formula, numVars));
+    CHECK(!parse("p cnf 2\n", formula, numVars));
+    CHECK(!parse("p dnf 2 1\n1 0\n", formula, numVars));
+    CHECK(!parse("p cnf 2 1\np cnf 2 1\n1 0\n", formula, numVars));
+    CHECK(!parse("p cnf 99999999999 1\n1 0\n", formula, numVars));
+    // 2 * (numVars + 1) literal slots must still fit in an int.
+    CHECK(!parse("p cnf 1073741823 1\n1 0\n", formula, numVars));
+    CHECK(parse("p cnf 1073741822 1\n1 0\n", formula, numVars) && numVars == 1073741822);
+}
+
+static void testRoundTrip() {
+    mt19937 rng(9);
+    for (int iter = 0; iter < 100; ++iter) {
+        int numVars = 1 + static_cast<int>(rng() % 50);
+        IntFormula formula = randomFormula(rng, numVars, static_cast<int>(rng() % 200), 6), parsed;
+        ostringstream out;
+        writeDimacs(formula, numVars, out);
+        int parsedVars = 0;
+        CHECK(parse(out.str(), parsed, parsedVars));
+        CHECK(parsedVars == numVars && parsed == formula);
+    }
+}
+
+static void testModelOutput() {
+    ostringstream unsat;
+    writeDimacsModel(Model(), 3, unsat);
+    CHECK(unsat.str() == "s UNSATISFIABLE\n");
+
+    // Long models wrap before 80 columns; unassigned variables print as false.
+    Model model(31, VAL_TRUE);
+    model[2] = VAL_FALSE;
+    model[3] = VAL_UNASSIGNED;
+    ostringstream sat;
+    writeDimacsModel(model, 30, sat);
+    string line;
+    istringstream lines(sat.str());
+    getline(lines, line);
+    CHECK(line == "s SATISFIABLE");
+    int next = 1;
+    while (getline(lines, line)) {
+        CHECK(line.size() < 80 && line.compare(0, 2, "v ") == 0);
+        istringstream literals(line.substr(2));
+        int literal;
+        while (literals >> literal) {
+            if (next > 30) {
+                CHECK(literal == 0);
+                continue;
+            }
+            CHECK(literal == (next == 2 || next == 3 ? -next : next));
+            ++next;
+        }
+    }
+    CHECK(next == 31);
+}
+
+int main() {
+    testParse();
+    testErrors();
+    testRoundTrip();
+    testModelOutput();
+    return testResult("DimacsTest");
+}
@@ -0,0 +1,83 @@
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include "TestUtil.h"
+#include "InputFile.h"
+
+static vector<string> lines(const string &text) {
+    vector<string> result;
+    LineCursor cursor(text.data(), text.size());
+    LineView line;
+    while (cursor.next(line)) {
+        result.emplace_back(line.data, line.size);
+    }
+    return result;
+}
+
+static void testLineCursor() {
+    CHECK(lines("").empty());
+    CHECK(lines("a\nbc\n") == vector<string>({"a", "bc"}));
+    CHECK(lines("a\r\n\r\nb") == vector<string>({"a", "", "b"}));
+    CHECK(lines("\n\n") == vector<string>({"", ""}));
+    CHECK(lines("a\rb\r") == vector<string>({"a\rb"}));
+}
+
+// Large enough to take several read() chunks through a pipe.
+static string sampleText() {
+    string text;
+    mt19937 rng(10);
+    while (text.size() < 3u << 20) {
+        text += to_string(rng()) + (rng() & 1 ? "\n" : "\r\n");
+    }
+    return text;
+}
+
+static void testRegularFile() {
+    const char *path = "InputFileTest.tmp";
+    string text = sampleText();
+    ofstream(path, ios::binary) << text;
+    InputFile file;
+    CHECK(file.open(path));
+    CHECK(string(file.data(), file.size()) == text);
+
+    ofstream(path, ios::binary | ios::trunc);
+    CHECK(file.open(path));
+    CHECK(file.size() == 0);
+    remove(path);
+
+    CHECK(!file.open("InputFileTest.missing"));
+}
+
+// Opened through /dev/fd, which is not a regular file, so it is read instead of
+// mapped. Without a reader the writer gets EPIPE rather than blocking.
+static void testPipe() {
+    signal(SIGPIPE, SIG_IGN);
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    string text = sampleText();
+    thread writer([&text, &fds]() {
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t count = write(fds[1], text.data() + written, text.size() - written);
+            if (count <= 0) {
+                break;
+            }
+            written += static_cast<size_t>(count);
+        }
+        close(fds[1]);
+    });
+    InputFile file;
+    CHECK(file.open("/dev/fd/" + to_string(fds[0])));
+    close(fds[0]);
+    writer.join();
+    CHECK(string(file.data(), file.size()) == text);
+}
+
+int main() {
+    testLineCursor();
+    testRegularFile();
+    testPipe();
+    return testResult("InputFileTest");
+}
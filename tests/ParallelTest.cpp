@@ -0,0 +1,129 @@
+#include <thread>
+#include "TestUtil.h"
+#include "ClauseExchange.h"
+#include "CubeAndConquer.h"
+#include "Portfolio.h"
+
+static void testExchangeSingleThread() {
+    ClauseExchange exchange(4);
+    CHECK(exchange.publish(0, {1, 2}));
+    CHECK(exchange.publish(1, {3}));
+    CHECK(!exchange.publish(0, {}));
+    CHECK(!exchange.publish(0, IntClause(ClauseExchange::MAX_LENGTH + 1, 1)));
+
+    // Readers skip their own clauses and only see each clause once.
+    uint64_t cursor0 = 0, cursor1 = 0;
+    vector<IntClause> seen0, seen1;
+    exchange.collect(0, cursor0, seen0);
+    exchange.collect(1, cursor1, seen1);
+    CHECK(seen0 == vector<IntClause>({{3}}));
+    CHECK(seen1 == vector<IntClause>({{1, 2}}));
+    seen0.clear();
+    exchange.collect(0, cursor0, seen0);
+    CHECK(seen0.empty());
+
+    // A reader that fell behind by more than the capacity only gets the newest clauses.
+    for (int i = 1; i <= 10; ++i) {
+        CHECK(exchange.publish(1, {i}));
+    }
+    exchange.collect(0, cursor0, seen0);
+    CHECK(seen0 == vector<IntClause>({{7}, {8}, {9}, {10}}));
+}
+
+// Clause k of writer source: 1 + k % MAX_LENGTH literals that all encode
+// (source, k), so a torn read shows up as a mix.
+static IntClause writerClause(int source, int k) {
+    IntClause clause;
+    for (int i = 0; i <= k % ClauseExchange::MAX_LENGTH; ++i) {
+        clause.push_back((source + 1) * 10000000 + k * 10 + i);
+    }
+    return clause;
+}
+
+static void testExchangeConcurrent() {
+    const int writers = 4, perWriter = 20000;
+    ClauseExchange exchange(64);
+    vector<thread> threads;
+    for (int source = 1; source <= writers; ++source) {
+        threads.emplace_back([&exchange, source]() {
+            for (int k = 0; k < perWriter; ++k) {
+                exchange.publish(source, writerClause(source, k));
+            }
+        });
+    }
+
+    // Reader 0 runs alongside; it may miss clauses but must never see a torn one.
+    uint64_t cursor = 0;
+    long long collected = 0, torn = 0;
+    vector<IntClause> batch;
+    for (int round = 0; round < 20000; ++round) {
+        batch.clear();
+        exchange.collect(0, cursor, batch);
+        for (const IntClause &clause : batch) {
+            int source = clause[0] / 10000000 - 1;
+            int k = clause[0] % 10000000 / 10;
+            torn += source < 1 || source > writers || clause != writerClause(source, k);
+        }
+        collected += batch.size();
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+    batch.clear();
+    exchange.collect(0, cursor, batch);
+    CHECK(torn == 0);
+    CHECK(collected + static_cast<long long>(batch.size()) > 0);
+}
+
+static void testPortfolio() {
+    mt19937 rng(3);
+    for (int iter = 0; iter < 60; ++iter) {
+        int numVars = 40 + static_cast<int>(rng() % 40);
+        IntFormula formula = randomFormula(rng, numVars, numVars * 4 + static_cast<int>(rng() % numVars), 3);
+        Model reference = dpll(formula, numVars);
+        vector<SolverOptions> configs = portfolioConfigs(SolverOptions(), 2 + iter % 4);
+        int winner = -1;
+        Model model = solvePortfolio(formula, numVars, configs, iter & 1, &winner);
+        CHECK(model.empty() == reference.empty());
+        CHECK(model.empty() || satisfies(model, formula));
+        CHECK(winner >= 0 && winner < static_cast<int>(configs.size()));
+    }
+}
+
+// The cubes must cover every model: the formula is satisfiable exactly when
+// one of its cubes is.
+static void testCubes() {
+    mt19937 rng(5);
+    for (int iter = 0; iter < 300; ++iter) {
+        int numVars = 4 + static_cast<int>(rng() % 11);
+        IntFormula formula = randomFormula(rng, numVars, numVars * (2 + static_cast<int>(rng() % 4)), 3);
+        bool covered = false;
+        for (const vector<Literal> &cube : makeCubes(formula, numVars, 1 + static_cast<int>(rng() % 16))) {
+            covered = covered || bruteForceSat(formula, numVars, cube);
+        }
+        CHECK(covered == bruteForceSat(formula, numVars));
+    }
+}
+
+static void testCubeAndConquer() {
+    mt19937 rng(6);
+    for (int iter = 0; iter < 60; ++iter) {
+        int numVars = 40 + static_cast<int>(rng() % 40);
+        IntFormula formula = randomFormula(rng, numVars, numVars * 4 + static_cast<int>(rng() % numVars), 3);
+        Model reference = dpll(formula, numVars);
+        SolverOptions options;
+        options.mode = iter & 1 ? MODE_CDCL : MODE_DPLL;
+        Model model = solveCubeAndConquer(formula, numVars, options, 1 + iter % 4, 32);
+        CHECK(model.empty() == reference.empty());
+        CHECK(model.empty() || satisfies(model, formula));
+    }
+}
+
+int main() {
+    testExchangeSingleThread();
+    testExchangeConcurrent();
+    testPortfolio();
+    testCubes();
+    testCubeAndConquer();
+    return testResult("ParallelTest");
+}
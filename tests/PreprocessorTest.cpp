@@ -0,0 +1,74 @@
+#include "TestUtil.h"
+#include "CNFConverter.h"
+#include "Preprocessor.h"
+#include "VariableTable.h"
+
+// Simplifies formula, solves what is left and maps the model back: the answer
+// must match expected and the extended model must satisfy the original formula,
+// with every variable assigned.
+static void checkPreprocessed(const IntFormula &formula, int numVars, bool expected) {
+    Preprocessor preprocessor(numVars);
+    IntFormula simplified = formula;
+    bool consistent = preprocessor.simplify(simplified);
+    CHECK(consistent || expected == false);
+    CHECK(consistent || simplified == IntFormula({{}}));
+
+    const PreprocessStats &stats = preprocessor.stats();
+    CHECK(stats.clausesBefore == static_cast<long long>(formula.size()));
+    CHECK(stats.clausesAfter == static_cast<long long>(simplified.size()));
+
+    Model model = dpll(simplified, numVars);
+    CHECK(!model.empty() == expected);
+    preprocessor.extendModel(model);
+    if (!model.empty()) {
+        CHECK(satisfies(model, formula));
+        for (int var = 1; var <= numVars; ++var) {
+            CHECK(model[var] != VAL_UNASSIGNED);
+        }
+    }
+}
+
+// Random clauses plus chains of equivalences, so that substitution has work.
+static void testRandomFormulas() {
+    mt19937 rng(12);
+    for (int iter = 0; iter < 2000; ++iter) {
+        int numVars = 3 + static_cast<int>(rng() % 12);
+        IntFormula formula = randomFormula(rng, numVars, numVars * (1 + static_cast<int>(rng() % 4)), 4);
+        for (int i = static_cast<int>(rng() % 4); i > 0; --i) {
+            Literal a = randomLiteral(rng, numVars), b = randomLiteral(rng, numVars);
+            formula.push_back({-a, b});
+            formula.push_back({a, -b});
+        }
+        checkPreprocessed(formula, numVars, bruteForceSat(formula, numVars));
+    }
+}
+
+// Tseitin output is what elimination and substitution are for.
+static void testTseitinFormulas() {
+    mt19937 rng(13);
+    const char *const ops[] = {" ^ ", " v ", " => ", " <=> "};
+    for (int iter = 0; iter < 300; ++iter) {
+        vector<string> exprs;
+        for (int i = static_cast<int>(rng() % 6); i >= 0; --i) {
+            string expr(1, static_cast<char>('A' + rng() % 8));
+            for (int j = static_cast<int>(rng() % 6); j > 0; --j) {
+                string operand = (rng() & 1 ? "!" : "") + string(1, static_cast<char>('A' + rng() % 8));
+                expr = "(" + expr + ops[rng() % 4] + operand + ")";
+            }
+            exprs.push_back(expr);
+        }
+        VariableTable variables;
+        IntFormula formula;
+        for (const string &clause : CNFConverter(CNF_TSEITIN, 1).convert(exprs)) {
+            formula.push_back(variables.internClause(clause));
+        }
+        Model reference = dpll(formula, variables.size());
+        checkPreprocessed(formula, variables.size(), !reference.empty());
+    }
+}
+
+int main() {
+    testRandomFormulas();
+    testTseitinFormulas();
+    return testResult("PreprocessorTest");
+}
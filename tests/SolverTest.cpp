@@ -0,0 +1,142 @@
+#include "TestUtil.h"
+#include "Solver.h"
+
+// Random search settings. MRV gets arbitrary groups of variables: they only
+// steer branching, so the answer must not depend on them.
+static SolverOptions randomOptions(mt19937 &rng, int numVars) {
+    SolverOptions options;
+    options.mode = rng() & 1 ? MODE_CDCL : MODE_DPLL;
+    options.heuristic = static_cast<BranchHeuristic>(rng() % 3);
+    options.phaseSaving = rng() & 1;
+    options.phase = static_cast<InitialPhase>(rng() % 3);
+    options.seed = rng() % 4;
+    options.restart = static_cast<RestartPolicy>(rng() % 3);
+    options.lubyUnit = 1 + static_cast<int>(rng() % 8);
+    options.restartMinConflicts = 1 + static_cast<int>(rng() % 8);
+    options.pureLiterals = rng() & 1;
+    options.probing = rng() & 1;
+    options.probeLevels = static_cast<int>(rng() % 3);
+    if (options.heuristic == HEURISTIC_MRV) {
+        for (int var = 1; var <= numVars; var += 3) {
+            options.mrvGroups.push_back({var, min(var + 1, numVars), min(var + 2, numVars)});
+        }
+    }
+    return options;
+}
+
+// Small formulas around the 3-SAT threshold against exhaustive enumeration.
+static void testAgainstBruteForce() {
+    mt19937 rng(1);
+    for (int iter = 0; iter < 3000; ++iter) {
+        int numVars = 3 + static_cast<int>(rng() % 12);
+        IntFormula formula = randomFormula(rng, numVars, numVars * (2 + static_cast<int>(rng() % 4)), 3);
+        bool expected = bruteForceSat(formula, numVars);
+        Model model = dpll(formula, numVars, randomOptions(rng, numVars));
+        CHECK(!model.empty() == expected);
+        if (!model.empty()) {
+            CHECK(satisfies(model, formula));
+        }
+    }
+}
+
+// Formulas too big to enumerate: every configuration must agree with a default
+// solver, and every model must check out.
+static void testAgainstFreshSolver() {
+    mt19937 rng(2);
+    for (int iter = 0; iter < 300; ++iter) {
+        int numVars = 30 + static_cast<int>(rng() % 30);
+        IntFormula formula = randomFormula(rng, numVars, numVars * 4 + static_cast<int>(rng() % numVars), 3);
+        Model reference = dpll(formula, numVars);
+        if (!reference.empty()) {
+            CHECK(satisfies(reference, formula));
+        }
+        for (int run = 0; run < 4; ++run) {
+            Model model = dpll(formula, numVars, randomOptions(rng, numVars));
+            CHECK(model.empty() == reference.empty());
+            if (!model.empty()) {
+                CHECK(satisfies(model, formula));
+            }
+        }
+    }
+}
+
+// One warm solver answers a series of assumption sets. SAT: the model keeps
+// every assumption. UNSAT: the core is a subset of the assumptions and, when
+// analyzed, already unsatisfiable together with the clauses.
+static void testAssumptions() {
+    mt19937 rng(4);
+    for (int iter = 0; iter < 1500; ++iter) {
+        int numVars = 3 + static_cast<int>(rng() % 12);
+        IntFormula formula = randomFormula(rng, numVars, numVars * (1 + static_cast<int>(rng() % 3)), 3);
+        SolverOptions options = randomOptions(rng, numVars);
+        Solver solver(numVars, options);
+        bool consistent = true;
+        for (const IntClause &clause : formula) {
+            consistent = solver.addClause(clause) && consistent;
+        }
+        for (int call = 0; consistent && call < 8; ++call) {
+            vector<Literal> assumptions;
+            for (int i = static_cast<int>(rng() % 8); i > 0; --i) {
+                assumptions.push_back(randomLiteral(rng, numVars));
+            }
+            bool satisfiable = solver.solve(assumptions);
+            CHECK(!solver.interrupted());
+            CHECK(satisfiable == bruteForceSat(formula, numVars, assumptions));
+            if (satisfiable) {
+                Model model = solver.model();
+                CHECK(satisfies(model, formula));
+                for (Literal literal : assumptions) {
+                    CHECK(literalTrue(model, literal));
+                }
+                continue;
+            }
+            const vector<Literal> &core = solver.failedAssumptions();
+            for (Literal literal : core) {
+                CHECK(find(assumptions.begin(), assumptions.end(), literal) != assumptions.end());
+            }
+            CHECK(options.mode == MODE_DPLL || solver.failedAssumptionsAnalyzed());
+            if (solver.failedAssumptionsAnalyzed()) {
+                CHECK(!bruteForceSat(formula, numVars, core));
+            }
+        }
+    }
+}
+
+static void testEdgeCases() {
+    CHECK(!dpll(IntFormula(), 0).empty());
+    CHECK(!dpll(IntFormula{{1, -1}}, 1).empty());
+    CHECK(dpll(IntFormula{{}}, 1).empty());
+    CHECK(dpll(IntFormula{{1}, {-1}}, 1).empty());
+
+    Solver solver(2);
+    CHECK(solver.addClause({1, 2}));
+    CHECK(!solver.addClause({}));
+    CHECK(!solver.solve());
+
+    // The core leaves out the assumption that plays no part, and the solver
+    // stays usable after an UNSAT answer.
+    SolverOptions cdcl;
+    cdcl.mode = MODE_CDCL;
+    Solver warm(3, cdcl);
+    CHECK(warm.addClause({-1, -2}));
+    CHECK(!warm.solve({3, 1, 2}));
+    vector<Literal> core = warm.failedAssumptions();
+    sort(core.begin(), core.end());
+    CHECK(core == vector<Literal>({1, 2}));
+    CHECK(warm.solve({3, 1}));
+    CHECK(warm.solve());
+
+    // The string interface adds the initial assignments as units.
+    Formula formula = {{"a", "b"}, {"!a", "c"}};
+    Assignment result = dpll(formula, {{"b", false}});
+    CHECK(result.size() == 3 && result["a"] && result["c"] && !result["b"]);
+    CHECK(dpll(formula, {{"b", false}, {"c", false}}).empty());
+}
+
+int main() {
+    testAgainstBruteForce();
+    testAgainstFreshSolver();
+    testAssumptions();
+    testEdgeCases();
+    return testResult("SolverTest");
+}
@@ -0,0 +1,188 @@
+#include <cstring>
+#include "TestUtil.h"
+#include "BatchSolver.h"
+#include "SudokuEncoder.h"
+#include "SudokuEngine.h"
+
+// Puzzles with a unique solution, from easy to hard for plain backtracking.
+static const char *const PUZZLES[] = {
+    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+    "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+    "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+    "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+};
+
+// No two givens clash, but the top right cell can only be a 9 and its box
+// already has one.
+static const char *const UNSOLVABLE = "12345678.........9...............................................................";
+
+static const KernelKind KERNELS[] = {KERNEL_SCALAR, KERNEL_SSE4, KERNEL_AVX2};
+
+static SudokuBoard puzzle(const char *line) {
+    SudokuBoard board;
+    CHECK(parsePuzzleLine(line, board));
+    return board;
+}
+
+static bool sameBoard(const SudokuBoard &a, const SudokuBoard &b) {
+    return memcmp(a.board, b.board, sizeof(a.board)) == 0;
+}
+
+// A solved grid: row r is the first row shifted by BoxSize * (r % BoxSize) + r / BoxSize.
+template <int BoxSize = 3>
+static int solvedDigit(int row, int col) {
+    return (BoxSize * (row % BoxSize) + row / BoxSize + col) % (BoxSize * BoxSize) + 1;
+}
+
+// Every kernel must turn the same grid into the same result. The grids place a
+// random subset of a solved board and give the open cells random candidates,
+// which usually keep the solution's digit so that most passes succeed.
+static void testKernelAgreement() {
+    struct alignas(64) Grid {
+        uint16_t cells[9 * KERNEL_LANES];
+        uint16_t rows[9], cols[9], boxes[9];
+    };
+    mt19937 rng(7);
+    EliminateKernel scalar = selectEliminateKernel(KERNEL_SCALAR);
+    for (int iter = 0; iter < 20000; ++iter) {
+        Grid input = {};
+        for (uint16_t &cell : input.cells) {
+            cell = KERNEL_PLACED;
+        }
+        int placedPercent = static_cast<int>(rng() % 90);
+        for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c) {
+                uint16_t bit = static_cast<uint16_t>(1 << (solvedDigit(r, c) - 1));
+                uint16_t &cell = input.cells[r * KERNEL_LANES + c];
+                if (static_cast<int>(rng() % 100) < placedPercent) {
+                    cell = bit | KERNEL_PLACED;
+                    input.rows[r] |= bit;
+                    input.cols[c] |= bit;
+                    input.boxes[r / 3 * 3 + c / 3] |= bit;
+                } else {
+                    cell = static_cast<uint16_t>(rng() & 0x1FF);
+                    if (rng() % 50) {
+                        cell |= bit;
+                    }
+                }
+            }
+        }
+
+        Grid expected = input;
+        KernelSingles expectedSingles;
+        bool expectedOk = scalar(expected.cells, expected.rows, expected.cols, expected.boxes, expectedSingles);
+        for (KernelKind kind : KERNELS) {
+            Grid grid = input;
+            KernelSingles singles;
+            bool ok = selectEliminateKernel(kind)(grid.cells, grid.rows, grid.cols, grid.boxes, singles);
+            CHECK(ok == expectedOk);
+            if (ok && expectedOk) {
+                CHECK(memcmp(grid.cells, expected.cells, sizeof(grid.cells)) == 0);
+                CHECK(memcmp(singles.naked, expectedSingles.naked, sizeof(singles.naked)) == 0);
+                CHECK(memcmp(singles.hidden, expectedSingles.hidden, sizeof(singles.hidden)) == 0);
+            }
+        }
+    }
+}
+
+// The native engine, on every kernel, and both SAT encodings must find the
+// same unique solution.
+static void testSolversAgree() {
+    SolverOptions cdcl;
+    cdcl.mode = MODE_CDCL;
+    cdcl.heuristic = HEURISTIC_MRV;
+    for (const char *line : PUZZLES) {
+        SudokuBoard givens = puzzle(line), expected;
+        CHECK(solveSudokuSat(givens, false, SolverOptions(), expected));
+        CHECK(isValidSolution(expected, givens));
+
+        SudokuBoard solution;
+        CHECK(solveSudokuSat(givens, true, SolverOptions(), solution) && sameBoard(solution, expected));
+        CHECK(solveSudokuSat(givens, true, cdcl, solution) && sameBoard(solution, expected));
+        for (KernelKind kind : KERNELS) {
+            SudokuEngine engine(kind);
+            CHECK(engine.solve(givens, solution) && sameBoard(solution, expected));
+        }
+    }
+
+    SudokuBoard givens = puzzle(UNSOLVABLE), solution;
+    CHECK(!solveSudokuSat(givens, false, SolverOptions(), solution));
+    CHECK(!solveSudokuSat(givens, true, cdcl, solution));
+    for (KernelKind kind : KERNELS) {
+        SudokuEngine engine(kind);
+        CHECK(!engine.solve(givens, solution));
+    }
+}
+
+// A warm solver must give the same answers as one-off solves, and the givens
+// it reports for an unsolvable puzzle must be among its givens and already
+// unsolvable on their own.
+static void testIncremental(SearchMode mode) {
+    SolverOptions options;
+    options.mode = mode;
+    options.heuristic = HEURISTIC_MRV;
+    IncrementalSudokuSolver<> solver(options);
+    for (int round = 0; round < 2; ++round) {
+        for (const char *line : PUZZLES) {
+            SudokuBoard givens = puzzle(line), expected, solution;
+            CHECK(solveSudokuSat(givens, false, SolverOptions(), expected));
+            CHECK(solver.solve(givens, solution) && sameBoard(solution, expected));
+        }
+
+        SudokuBoard givens = puzzle(UNSOLVABLE), solution;
+        CHECK(!solver.solve(givens, solution));
+        const SudokuBoard &conflicting = solver.conflictingGivens();
+        bool empty = true;
+        for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c) {
+                int digit = conflicting.board[r][c];
+                CHECK(!digit || digit == givens.board[r][c]);
+                empty = empty && !digit;
+            }
+        }
+        CHECK(mode == MODE_DPLL || !empty);
+        if (!empty) {
+            CHECK(!solveSudokuSat(conflicting, false, SolverOptions(), solution));
+        }
+    }
+}
+
+// Blanks out cells of a solved board at random; the SAT solver must complete
+// it with either encoding.
+template <int BoxSize>
+static void testLargeBoard(mt19937 &rng, int blankPercent) {
+    const int side = SudokuGrid<BoxSize>::SIDE;
+    SudokuGrid<BoxSize> givens;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            if (static_cast<int>(rng() % 100) >= blankPercent) {
+                givens.setCell(r, c, solvedDigit<BoxSize>(r, c));
+            }
+        }
+    }
+    SolverOptions options;
+    options.mode = MODE_CDCL;
+    options.heuristic = HEURISTIC_MRV;
+    for (bool reduced : {false, true}) {
+        SudokuGrid<BoxSize> solution;
+        CHECK(solveSudokuSat(givens, reduced, options, solution));
+        CHECK(isValidSolution(solution, givens));
+    }
+}
+
+int main() {
+    testKernelAgreement();
+    testSolversAgree();
+    testIncremental(MODE_DPLL);
+    testIncremental(MODE_CDCL);
+    // Random blanks make partial Latin squares, which get very hard around half
+    // blank on 25x25; stay clear of that band.
+    mt19937 rng(8);
+    for (int blankPercent : {30, 60, 90}) {
+        testLargeBoard<4>(rng, blankPercent);
+    }
+    for (int blankPercent : {30, 95}) {
+        testLargeBoard<5>(rng, blankPercent);
+    }
+    return testResult("SudokuTest");
+}
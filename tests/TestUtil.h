@@ -0,0 +1,92 @@
+#ifndef AILAB2_TESTUTIL_H
+#define AILAB2_TESTUTIL_H
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "DPLL.h"
+
+using namespace std;
+
+// Shared helpers for the test executables. A failed CHECK reports itself on
+// cerr and the run carries on; testResult() turns the count into the exit code.
+
+inline int &testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << endl; \
+            ++testFailures(); \
+        } \
+    } while (0)
+
+inline int testResult(const char *name) {
+    if (testFailures()) {
+        cerr << name << ": " << testFailures() << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << name << ": ok" << endl;
+    return 0;
+}
+
+inline Literal randomLiteral(mt19937 &rng, int numVars) {
+    Literal var = 1 + static_cast<int>(rng() % numVars);
+    return rng() & 1 ? var : -var;
+}
+
+// numClauses clauses of 1 to maxLength literals; duplicates and tautologies are
+// left in on purpose.
+inline IntFormula randomFormula(mt19937 &rng, int numVars, int numClauses, int maxLength) {
+    IntFormula formula(numClauses);
+    for (IntClause &clause : formula) {
+        int length = 1 + static_cast<int>(rng() % maxLength);
+        for (int i = 0; i < length; ++i) {
+            clause.push_back(randomLiteral(rng, numVars));
+        }
+    }
+    return formula;
+}
+
+inline bool literalTrue(const Model &model, Literal literal) {
+    int var = abs(literal);
+    return var < static_cast<int>(model.size()) && model[var] == (literal > 0 ? VAL_TRUE : VAL_FALSE);
+}
+
+// A tautology counts as satisfied even if its variable was left unassigned.
+inline bool satisfies(const Model &model, const IntFormula &formula) {
+    for (const IntClause &clause : formula) {
+        bool satisfied = false;
+        for (Literal literal : clause) {
+            satisfied = satisfied || literalTrue(model, literal) ||
+                        find(clause.begin(), clause.end(), -literal) != clause.end();
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reference answer by enumerating every assignment; keep numVars small.
+inline bool bruteForceSat(const IntFormula &formula, int numVars, const vector<Literal> &units = {}) {
+    Model model(numVars + 1);
+    for (uint32_t bits = 0; bits < (1u << numVars); ++bits) {
+        for (int var = 1; var <= numVars; ++var) {
+            model[var] = bits >> (var - 1) & 1 ? VAL_TRUE : VAL_FALSE;
+        }
+        bool ok = satisfies(model, formula);
+        for (size_t i = 0; ok && i < units.size(); ++i) {
+            ok = literalTrue(model, units[i]);
+        }
+        if (ok) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif //AILAB2_TESTUTIL_H